@@ -0,0 +1,49 @@
+#pragma once
+#include "MapGenerator.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Builds maps on a background thread so the editor keeps drawing the
+// current map meanwhile. A new request cancels the one in flight; only
+// the latest finished map is handed out, preceded by progressive previews.
+class AsyncGenerator {
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    bool hasPending = false;
+    MapParams pending;
+    StageCache pendingStages;
+    std::shared_ptr<GenerationProgress> active;
+    MapParams activeParams;
+    std::unique_ptr<MapGenerator> finished;
+    std::unique_ptr<Grid2D<TerrainTile>> preview;
+
+    void workerLoop();
+
+public:
+    AsyncGenerator();
+    ~AsyncGenerator();
+    AsyncGenerator(const AsyncGenerator&) = delete;
+    AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+
+    // Starts generating params, cancelling any generation in progress.
+    // Stages in reuse that still match params are not recomputed.
+    void request(const MapParams& params, StageCache reuse = StageCache());
+    void cancel();
+
+    // True while a request is queued or running
+    bool isBusy();
+    // Parameters of the queued or running request
+    MapParams getRequested();
+    // Completion of the running generation in [0, 1]
+    float getProgress();
+    // The most recently finished map, or nullptr
+    std::unique_ptr<MapGenerator> takeResult();
+    // Coarse terrain of the running generation, newer than the last call,
+    // or nullptr. Previews come coarse to fine before the result.
+    std::unique_ptr<Grid2D<TerrainTile>> takePreview();
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include "MapGenerator.h"
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// Terrain of a world too large to hold at once. The map is split into
+// square chunks generated on demand from the same parameters as
+// MapGenerator, so a chunk equals the matching part of a monolithic map.
+// Chunks live in an LRU cache of fixed capacity; edits are kept per chunk
+// and replayed when an evicted chunk is generated again.
+class ChunkedWorld {
+public:
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long evictions = 0;
+    };
+
+    ChunkedWorld(const MapParams& params, int chunkSize = 256, int capacity = 64);
+
+    int getWidth() const { return params.width; }
+    int getHeight() const { return params.height; }
+    int getChunkSize() const { return chunkSize; }
+    int chunksX() const { return (params.width + chunkSize - 1) / chunkSize; }
+    int chunksY() const { return (params.height + chunkSize - 1) / chunkSize; }
+
+    // Tiles of chunk (cx, cy), generating it if needed; edge chunks are
+    // smaller. The reference is valid until the next call that loads chunks.
+    const Grid2D<TerrainTile>& getChunk(int cx, int cy);
+    // Loads every chunk overlapping rect (tile coordinates), e.g. the
+    // viewport, so drawing it causes no generation
+    void touch(const DirtyRect& rect);
+
+    // Tile access in grid coordinates (row 0 first, as in MapGenerator::getGrid)
+    TerrainId getTerrain(int x, int y);
+    void setTerrain(int x, int y, TerrainId terrain);
+
+    // At least one chunk; evicts least recently used chunks beyond it
+    void setCapacity(int chunks);
+    int getCapacity() const { return capacity; }
+    int residentChunks() const { return static_cast<int>(chunks.size()); }
+    const Stats& getStats() const { return stats; }
+
+    // Streams the world chunk row by chunk row, so memory stays bounded
+    // by the cache whatever the world size
+    bool exportToPPM(const std::string& filename);
+
+private:
+    struct Chunk {
+        int cx, cy;
+        Grid2D<TerrainTile> tiles;
+    };
+
+    MapParams params;
+    int chunkSize;
+    int capacity;
+    OctaveTable octaveTable;
+    NoiseKernel noise;
+
+    std::list<Chunk> chunks;  // most recently used first
+    std::unordered_map<std::int64_t, std::list<Chunk>::iterator> index;
+    // Edited tiles per chunk, by offset within the chunk
+    std::unordered_map<std::int64_t, std::unordered_map<int, TerrainId>> edits;
+    Stats stats;
+
+    static std::int64_t key(int cx, int cy) {
+        return (static_cast<std::int64_t>(cy) << 32) | static_cast<std::uint32_t>(cx);
+    }
+    void generateChunk(Chunk& chunk);
+};
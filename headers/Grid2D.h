@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Non-owning view of a rectangle of cells. stride is the distance between
+// rows in elements, so views can address a sub-rectangle of a larger grid.
+template <class T>
+struct Grid2DView {
+    T* data = nullptr;
+    int width = 0;
+    int height = 0;
+    std::ptrdiff_t stride = 0;
+
+    T* row(int y) const { return data + y * stride; }
+    T& operator()(int x, int y) const { return data[y * stride + x]; }
+
+    Grid2DView sub(int x, int y, int w, int h) const { return {data + y * stride + x, w, h, stride}; }
+    operator Grid2DView<const T>() const { return {data, width, height, stride}; }
+};
+
+// Contiguous 2D container used for all map layers. Rows are padded so each
+// one starts on a 64-byte boundary (SIMD loads, cache lines), and the whole
+// grid is one allocation that resize() reuses when it is large enough.
+template <class T>
+class Grid2D {
+    static_assert(std::is_trivially_copyable_v<T>, "Grid2D stores plain cell values");
+    static_assert(64 % sizeof(T) == 0, "cell size must divide the row alignment");
+
+public:
+    static constexpr std::size_t alignment = 64;
+
+    Grid2D() = default;
+    Grid2D(int w, int h, T value = T()) {
+        resize(w, h);
+        fill(value);
+    }
+
+    Grid2D(const Grid2D& other) {
+        resize(other.w, other.h);
+        if (other.cells) std::memcpy(cells, other.cells, other.sizeBytes());
+    }
+
+    Grid2D(Grid2D&& other) noexcept
+        : cells(std::exchange(other.cells, nullptr)), w(std::exchange(other.w, 0)), h(std::exchange(other.h, 0)),
+          rowStride(std::exchange(other.rowStride, 0)), capacity(std::exchange(other.capacity, 0)) {}
+
+    Grid2D& operator=(const Grid2D& other) {
+        if (this != &other) {
+            resize(other.w, other.h);
+            if (other.cells) std::memcpy(cells, other.cells, other.sizeBytes());
+        }
+        return *this;
+    }
+
+    Grid2D& operator=(Grid2D&& other) noexcept {
+        std::swap(cells, other.cells);
+        std::swap(w, other.w);
+        std::swap(h, other.h);
+        std::swap(rowStride, other.rowStride);
+        std::swap(capacity, other.capacity);
+        return *this;
+    }
+
+    ~Grid2D() { release(); }
+
+    // Contents are unspecified after a size change; newly allocated storage
+    // is value-initialized. Keeps the allocation when it is big enough.
+    void resize(int newWidth, int newHeight) {
+        if (newWidth == w && newHeight == h) return;
+        const std::size_t perLine = alignment / sizeof(T);
+        const std::size_t stride = (static_cast<std::size_t>(newWidth) + perLine - 1) / perLine * perLine;
+        const std::size_t needed = stride * static_cast<std::size_t>(newHeight);
+        if (needed > capacity) {
+            release();
+            cells = static_cast<T*>(::operator new(needed * sizeof(T), std::align_val_t{alignment}));
+            capacity = needed;
+            for (std::size_t i = 0; i < needed; ++i) new (cells + i) T();
+        }
+        w = newWidth;
+        h = newHeight;
+        rowStride = stride;
+    }
+
+    void fill(T value) {
+        for (int y = 0; y < h; ++y) {
+            T* r = row(y);
+            for (int x = 0; x < w; ++x) r[x] = value;
+        }
+    }
+
+    int width() const { return w; }
+    int height() const { return h; }
+    std::ptrdiff_t stride() const { return static_cast<std::ptrdiff_t>(rowStride); }
+    bool empty() const { return w == 0 || h == 0; }
+
+    // Bytes covered by all rows including padding
+    std::size_t sizeBytes() const { return rowStride * static_cast<std::size_t>(h) * sizeof(T); }
+
+    T* data() { return cells; }
+    const T* data() const { return cells; }
+    T* row(int y) { return cells + y * rowStride; }
+    const T* row(int y) const { return cells + y * rowStride; }
+    T& operator()(int x, int y) { return cells[y * rowStride + x]; }
+    const T& operator()(int x, int y) const { return cells[y * rowStride + x]; }
+
+    Grid2DView<T> view() { return {cells, w, h, stride()}; }
+    Grid2DView<const T> view() const { return {cells, w, h, stride()}; }
+
+private:
+    T* cells = nullptr;
+    int w = 0;
+    int h = 0;
+    std::size_t rowStride = 0;
+    std::size_t capacity = 0;
+
+    void release() {
+        if (cells) ::operator delete(cells, std::align_val_t{alignment});
+        cells = nullptr;
+        capacity = 0;
+    }
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include "MapGenerator.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+// Generated maps by the parameters they were built from, so going back to
+// earlier parameters needs no generation. Entries are copies taken when a
+// map arrives, before any terrain edits, and share their noise layers with
+// it. Least recently used maps are dropped once the cached layers exceed
+// the byte budget; shared layers count once per map, so actual memory
+// stays below it.
+class MapCache {
+public:
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long evictions = 0;
+    };
+
+    explicit MapCache(std::size_t budgetBytes = std::size_t(256) << 20);
+
+    // Remembers map under map.getParams(), replacing an older entry. Maps
+    // larger than the budget are ignored.
+    void put(const MapGenerator& map);
+    // Copy of the map cached for params, or nullptr. Counts a hit or miss.
+    std::unique_ptr<MapGenerator> find(const MapParams& params);
+
+    void setBudget(std::size_t bytes);
+    std::size_t getBudget() const { return budget; }
+    std::size_t memoryBytes() const { return bytes; }
+    int size() const { return static_cast<int>(entries.size()); }
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Entry {
+        MapParams params;
+        std::unique_ptr<MapGenerator> map;
+        std::size_t bytes;
+    };
+
+    std::size_t budget;
+    std::size_t bytes = 0;
+    std::list<Entry> entries;  // most recently used first
+    std::unordered_map<MapParams, std::list<Entry>::iterator, MapParamsHash> index;
+    Stats stats;
+
+    // Drops least recently used entries until at most limit bytes are cached
+    void trim(std::size_t limit);
+};
@@ -0,0 +1,164 @@
+#pragma once
+#include "Terrain.h"
+#include "NoiseKernel.h"
+#include "MapParams.h"
+#include "Grid2D.h"
+#include <memory>
+#include <vector>
+#include <string>
+
+// Half-open rectangle of grid cells [x0, x1) x [y0, y1) in grid rows,
+// i.e. the same orientation as the texture data.
+struct DirtyRect {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+    int width() const { return x1 - x0; }
+    int height() const { return y1 - y0; }
+    void add(int x, int y);
+    void add(const DirtyRect& other);
+};
+
+// Layers produced by the expensive generation stages, with the parameters
+// they were built from. Layers are shared read-only between generators,
+// so a new map can adopt whichever stages its parameters did not change.
+struct StageCache {
+    MapParams noiseParams;
+    // octaveSums[k]: fractal sum of the first k octaves before normalization.
+    // Null where the prefix was not kept.
+    std::vector<std::shared_ptr<const Grid2D<float>>> octaveSums;
+    MapParams falloffParams;
+    std::shared_ptr<const Grid2D<float>> falloff;
+};
+
+// Generation runs as a pipeline of stages, each rerun only when its inputs
+// changed: raw noise (seed, size, noise settings) and falloff (size,
+// islandScale) feed combine (heightMap), which feeds classify (grid).
+// The noise stage keeps per-octave prefix sums, so changing the octave
+// count only computes the added octaves or picks up a shorter prefix.
+// When progress has an onPreview callback the noise stage runs coarse to
+// fine and hands out a block-filled grid after each coarse level.
+// Biome and cliff maps replace noise, combine and classify with one fused
+// pass that evaluates elevation, its gradient, moisture and temperature
+// together.
+// Colorize happens per dirty rectangle through the terrain palette.
+class MapGenerator {
+    // Octave prefix sums are all kept while they fit in this many bytes;
+    // beyond it only the final sum is, and removing octaves recomputes
+    static constexpr std::size_t octaveCacheBytes = 64u << 20;
+    // Lattice spacing of the first progressive preview
+    static constexpr int previewStep = 8;
+
+    int width, height;
+    float islandScale;
+    Grid2D<TerrainTile> grid;
+    Grid2D<float> heightMap;
+    std::vector<std::shared_ptr<Grid2D<float>>> octaveSums;  // see StageCache
+    // Unshared layers dropped by earlier generations, reused before
+    // allocating new ones
+    std::vector<std::shared_ptr<Grid2D<float>>> spareLayers;
+    std::shared_ptr<Grid2D<float>> falloffLayer;
+    // Scratch rows of the band loops, slots rows per parallelFor chunk, so
+    // each chunk owns its rows whichever thread runs it. Copies start
+    // without any: the contents never outlive a pass.
+    struct Scratch {
+        Grid2D<float> rows;
+        int slots = 0;
+        Scratch() = default;
+        Scratch(const Scratch&) {}
+        Scratch& operator=(const Scratch&) { return *this; }
+    } scratch;
+    MapParams noiseParams;
+    MapParams falloffParams;
+    bool noiseValid = false;
+    bool falloffValid = false;
+    bool heightValid = false;
+    NoiseKernel noise;
+    GenerationProgress* progress = nullptr;  // only while generating
+    bool cancelled = false;
+    bool isDirty = true;
+    DirtyRect dirtyRect;
+    unsigned int seed;
+    NoiseType noiseType;
+    FractalType fractal;
+    int octaves;
+    float persistence;
+    float lacunarity;
+    float baseScale;
+    bool classifyOnly = false;
+    bool biomes = false;
+    float cliffSlope = 0.0f;
+
+    bool isCancelled() const;
+    void addProgress(long long work);
+    void detachProgress();
+    // Layer to write new contents to: layer itself unless another map
+    // shares it, else a spare, else a new one. Contents are unspecified.
+    Grid2D<float>& freshLayer(std::shared_ptr<Grid2D<float>>& layer);
+    // Moves layer to the spares when no other map shares it
+    void retireLayer(std::shared_ptr<Grid2D<float>>& layer);
+    // Sizes scratch for slots rows of rowWidth per chunk of a loop over rows
+    void reserveScratch(int rowWidth, int rows, int slots);
+    // Row slot of the chunk starting at row begin
+    float* scratchRow(int begin, int slot);
+    void adopt(const StageCache& cache, const MapParams& params);
+    int cachedOctaves(int count) const;
+    void runStages(const MapParams& params);
+    void generateFalloffMap();
+    void generateNoiseMap();
+    void previewLevel(const Grid2D<float>& sums, int step);
+    void combineLayers();
+    void classifyTerrain();
+    void classifyDecided();
+    void generateFieldMap();
+
+public:
+    MapGenerator(int w, int h, float scale, unsigned int seed, 
+               int oct, float pers, float lac, float nScale,
+               NoiseType noiseType = NoiseType::Perlin);
+    // progress, when given, receives work counts and is polled for
+    // cancellation; a cancelled map is incomplete (see wasCancelled).
+    // Stages whose inputs match layers in reuse are adopted, not recomputed.
+    explicit MapGenerator(const MapParams& params, GenerationProgress* progress = nullptr,
+                          const StageCache* reuse = nullptr);
+    // Rebuilds this map for params, rerunning only the invalidated stages.
+    // Discards terrain edits. At an unchanged size layers are rewritten in
+    // place, so after the first few runs nothing is allocated (Baked noise
+    // still bakes a tile per new seed).
+    void regenerate(const MapParams& params, GenerationProgress* progress = nullptr);
+    // Island falloff of tile (x, y) on a width x height map: 1 at the centre,
+    // 0 from islandScale half-extents out
+    static float falloffAt(int x, int y, int width, int height, float islandScale);
+    // Slope (height change per tile) of the combined height at tile (x, y),
+    // from the noise sum there and its gradient
+    static float slopeAt(int x, int y, int width, int height, float islandScale, float sum, float dx, float dy);
+    // Terrain of a tile from its combined height (noise times falloff)
+    static TerrainId generateTerrainFromHeight(float h);
+    // Octaves of the moisture and temperature fields of biome maps; climate
+    // varies slowly, so they stop well before elevation does
+    static constexpr int climateOctaves = 4;
+    // Moisture or temperature of a climate field sum is 0.5 + sum * climateScale
+    static float climateScale(const OctaveTable& octaves);
+    // Terrain of a biome map tile from its combined height and its moisture
+    // and temperature, both centred on 0.5
+    static TerrainId generateBiome(float h, float moisture, float temperature);
+    bool wasCancelled() const { return cancelled; }
+    MapParams getParams() const;
+    StageCache getStageCache() const;
+    // Bytes held by this map's layers, spare layers and scratch rows,
+    // counting layers shared with other maps in full
+    std::size_t memoryBytes() const;
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const Grid2D<TerrainTile>& getGrid() const { return grid; }
+    // Empty for maps generated with MapParams::classifyOnly
+    const Grid2D<float>& getHeightMap() const { return heightMap; }
+    bool getIsDirty() const;
+    // Cells changed since the last markClean()
+    const DirtyRect& getDirtyRect() const { return dirtyRect; }
+    void markClean();
+    void setTerrain(int x, int y, TerrainId terrain);
+    void invertTextures();
+    bool exportToPNG(const std::string& filename) const;
+    bool exportToPPM(const std::string& filename) const;
+};
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include "NoiseKernel.h"
+#include <atomic>
+#include <functional>
+
+class MapGenerator;
+
+// Everything that determines a generated map
+struct MapParams {
+    int width = 300;
+    int height = 300;
+    float islandScale = 1.1f;
+    unsigned int seed = 0;
+    int octaves = 9;
+    float persistence = 0.5f;
+    float lacunarity = 2.0f;
+    float baseScale = 0.03f;
+    NoiseType noiseType = NoiseType::Perlin;
+    FractalType fractal = FractalType::FBm;
+    // Terrain only: the height map is left empty and each tile stops adding
+    // octaves once its terrain class is decided. The grid is unchanged.
+    bool classifyOnly = false;
+    // Land terrain from elevation, moisture and temperature fields computed
+    // in one fused noise pass, instead of from height alone
+    bool biomes = false;
+    // Land steeper than this (height change per tile) becomes Stone, using
+    // the analytic gradient of the noise and falloff. 0 disables cliffs.
+    float cliffSlope = 0.0f;
+
+    // Same noise inputs apart from the octave count: octave prefix sums carry over
+    bool sameOctaveBasis(const MapParams& o) const {
+        return width == o.width && height == o.height && seed == o.seed && persistence == o.persistence &&
+               lacunarity == o.lacunarity && baseScale == o.baseScale && noiseType == o.noiseType &&
+               fractal == o.fractal;
+    }
+    // Same inputs for the raw noise stage
+    bool sameNoise(const MapParams& o) const { return sameOctaveBasis(o) && octaves == o.octaves; }
+    // Same inputs for the falloff stage
+    bool sameFalloff(const MapParams& o) const {
+        return width == o.width && height == o.height && islandScale == o.islandScale;
+    }
+
+    bool operator==(const MapParams& o) const {
+        return sameNoise(o) && sameFalloff(o) && classifyOnly == o.classifyOnly && biomes == o.biomes &&
+               cliffSlope == o.cliffSlope;
+    }
+    bool operator!=(const MapParams& o) const { return !(*this == o); }
+};
+
+// Hash over the fields operator== compares, for containers keyed by parameters
+struct MapParamsHash {
+    std::size_t operator()(const MapParams& p) const {
+        std::size_t h = 0;
+        auto mix = [&h](std::size_t v) { h ^= v + 0x9e3779b9u + (h << 6) + (h >> 2); };
+        mix(std::hash<int>()(p.width));
+        mix(std::hash<int>()(p.height));
+        mix(std::hash<float>()(p.islandScale));
+        mix(std::hash<unsigned int>()(p.seed));
+        mix(std::hash<int>()(p.octaves));
+        mix(std::hash<float>()(p.persistence));
+        mix(std::hash<float>()(p.lacunarity));
+        mix(std::hash<float>()(p.baseScale));
+        mix(static_cast<std::size_t>(p.noiseType));
+        mix(static_cast<std::size_t>(p.fractal));
+        mix(static_cast<std::size_t>(p.classifyOnly) | static_cast<std::size_t>(p.biomes) << 1);
+        mix(std::hash<float>()(p.cliffSlope));
+        return h;
+    }
+};
+
+// Shared between a running generation and whoever watches it.
+// Setting cancelled makes the generator skip the remaining work; the
+// partially built map must then be discarded.
+struct GenerationProgress {
+    std::atomic<bool> cancelled{false};
+    std::atomic<long long> workDone{0};
+    std::atomic<long long> workTotal{1};
+    // Progressive preview: called on the generating thread with the map at
+    // each coarse level (its grid filled in step x step blocks). Set before
+    // generation starts.
+    std::function<void(const MapGenerator&, int step)> onPreview;
+
+    float fraction() const {
+        return static_cast<float>(static_cast<double>(workDone.load()) / static_cast<double>(workTotal.load()));
+    }
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+// Frequency and amplitude of every octave, built with the same running
+// products the original generateHeightMap loop used.
+struct OctaveTable {
+    static constexpr int maxOctaves = 32;
+    int count;
+    float frequency[maxOctaves];
+    float amplitude[maxOctaves];
+
+    OctaveTable(int octaves, float persistence, float lacunarity);
+};
+
+// Noise backend evaluated by NoiseKernel.
+// Perlin:       siv::PerlinNoise::noise2D, i.e. noise3D at SIVPERLIN_DEFAULT_Z
+//               (8 gradients, 7 lerps). Matches maps made before the kernels.
+// Perlin2D:     true 2D lattice on the same permutation (4 gradients,
+//               3 lerps). Visually equivalent, about twice as fast.
+// Hash:         2D gradient noise on an integer hash of the lattice
+//               coordinates instead of the 256-entry permutation, so it does
+//               not repeat every 256 cells (about 8.5k tiles at baseScale
+//               0.03) and needs no table lookups.
+// OpenSimplex2: simplex-grid noise on the same hash, 3 gradients per sample.
+//               Fewer directional artifacts than the square lattices.
+// Baked:        lower quality fast path for thumbnails and previews. Hash
+//               noise is baked once per seed into a small tileable table,
+//               and each octave reads it bilinearly through its own
+//               rotation and offset. Softer, and the first octave repeats
+//               every 16 lattice cells; 4-5x faster than Perlin.
+enum class NoiseType { Perlin, Perlin2D, Hash, OpenSimplex2, Baked };
+
+// How octaves are shaped before they are summed.
+// FBm:    plain sum of the noise (the original look).
+// Ridged: 2 (1 - |n|)^2 per octave, sharp mountain ridges.
+// Billow: 2 |n| per octave, rounded hills.
+// Both are shifted by their mean for the backend, so the mean height, and
+// with it the land share, stays near fBm's.
+enum class FractalType { FBm, Ridged, Billow };
+
+struct BakedTile;
+
+// Batched, single-precision fractal noise. Each NoiseType and FractalType
+// is a policy compiled into its own row loop (see NoiseKernel.cpp), so there
+// is no virtual call or branch per sample. Rows are processed simd::width
+// samples at a time.
+class NoiseKernel {
+    alignas(64) std::int32_t perm[512];  // doubled so corner lookups need no & 255
+    NoiseType type;
+    FractalType fractal;
+    std::int32_t hashSeed;
+    std::shared_ptr<const BakedTile> baked;  // NoiseType::Baked only, shared per seed
+
+    template <class Fn>
+    void dispatch(Fn&& fn) const;
+
+public:
+    static constexpr int maxFields = 4;
+
+    NoiseKernel(std::uint32_t seed, NoiseType t = NoiseType::Perlin, FractalType f = FractalType::FBm);
+
+    // out[i] = sum over octaves of shape(noise((x0 + i) * baseScale * f, y * baseScale * f)) * a
+    void fractalRow(float* out, int x0, int count, int y, float baseScale, const OctaveTable& octaves) const;
+
+    // Adds octaves [first, last) to the partial sums in (zeros when null), in
+    // the same order fractalRow does, so prefix sums extend bit-exactly.
+    // Sample i is column x0 + i * xStep. out may alias in.
+    void octaveRow(float* out, const float* in, int x0, int count, int y, float baseScale,
+                   const OctaveTable& octaves, int first, int last, int xStep = 1) const;
+
+    // fractalRow for callers that only bucket (sum + 1) / 2 * weight[i]
+    // (weight >= 0) by the thresholds in cuts. A group of samples
+    // stops once the remaining octaves cannot carry any of them across a cut,
+    // so out[i] may be a partial sum, but it always falls in the same bucket
+    // as the full sum.
+    void decidedRow(float* out, int x0, int count, int y, float baseScale, const OctaveTable& octaves,
+                    const float* weight, const float* cuts, int cutCount) const;
+
+    // Up to maxFields decorrelated fields in one pass over the row: out[f][i]
+    // sums the first counts[f] octaves of the field at a fixed lattice
+    // offset. Field 0 has no offset and the fractal shape, so it equals
+    // fractalRow; the others are plain fBm. The fields share the column
+    // coordinates and the per-octave frequency and amplitude setup.
+    // When dx and dy are given they receive the analytic gradient of field
+    // 0 per tile (d/dx along the row, d/dy across rows), summed over its
+    // octaves from the same lattice evaluations.
+    void fieldsRow(float* const* out, const int* counts, int fieldCount, int x0, int count, int y,
+                   float baseScale, const OctaveTable& octaves, float* dx = nullptr, float* dy = nullptr) const;
+};
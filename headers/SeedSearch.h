@@ -0,0 +1,56 @@
+#pragma once
+#include "Grid2D.h"
+#include "MapParams.h"
+#include "Terrain.h"
+#include <limits>
+#include <vector>
+
+// Shape of a generated map, as seen by seed search
+struct MapStats {
+    float land = 0.0f;       // share of tiles that are not water
+    float stone = 0.0f;      // share of tiles that are stone
+    int islands = 0;         // 4-connected land regions of at least minIslandTiles
+    float coastline = 0.0f;  // land/water tile edges
+
+    static MapStats of(const Grid2D<TerrainTile>& grid, float minIslandTiles = 1.0f);
+};
+
+// Accepted interval of one statistic; unbounded sides are infinite
+struct StatRange {
+    float min = -std::numeric_limits<float>::infinity();
+    float max = std::numeric_limits<float>::infinity();
+
+    // 0 in the middle of a bounded range and 1 at its edges; 0 anywhere
+    // inside a one-sided range. Beyond 1 outside, growing with the distance.
+    float penalty(float value) const;
+};
+
+struct SeedCriteria {
+    StatRange land, stone, islands, coastline;
+    // Smaller islands (in full size tiles) are rocks and not counted; low
+    // resolution search maps cannot see them anyway
+    float minIslandTiles = 16.0f;
+
+    // Sum of the penalties, lower is better. Maps meeting every range
+    // score below the number of bounded ranges.
+    float score(const MapStats& stats) const;
+};
+
+struct SeedResult {
+    unsigned int seed;
+    float score;
+    MapStats stats;  // counts and lengths in tiles of the full size map
+};
+
+// The map of params at a lower resolution: longSide tiles along its longer
+// side, the noise scale and cliff slope stretched to match and octaves
+// finer than a tile dropped. Terrain only (classifyOnly). Maps already
+// that small are returned as they are, apart from classifyOnly.
+MapParams downscaledParams(const MapParams& params, int longSide);
+
+// Generates seeds firstSeed .. firstSeed + count - 1 of params at longSide
+// resolution across the shared thread pool and returns the best `top` by
+// criteria, best first (ties by seed). Stats are scaled back to full size;
+// coastlines come out somewhat shorter than at full resolution.
+std::vector<SeedResult> searchSeeds(const MapParams& params, const SeedCriteria& criteria, unsigned int firstSeed,
+                                    int count, int top, int longSide = 128);
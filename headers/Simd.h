@@ -0,0 +1,264 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Thin wrapper over the widest float/int vector the build targets.
+// Kernels are written once against simd::f32/simd::i32 and compile to
+// AVX2 (8 lanes), SSE2 (4 lanes) or plain scalar code (1 lane).
+// Masks are i32 vectors with all bits set in the selected lanes.
+// Each wrapper rounds exactly like its scalar version, and mapcore is built
+// without fused multiply-add contraction (see CMakeLists.txt), so the three
+// levels give bit-identical maps. New wrappers must not use FMA either.
+
+#if !defined(MAPCORE_NO_SIMD) && defined(__AVX2__)
+#define MAPCORE_SIMD_AVX2 1
+#include <immintrin.h>
+#elif !defined(MAPCORE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MAPCORE_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#endif
+
+namespace simd {
+
+#if defined(MAPCORE_SIMD_AVX2)
+
+constexpr int width = 8;
+constexpr const char* name = "AVX2";
+
+struct f32 { __m256 v; };
+struct i32 { __m256i v; };
+
+inline f32 splatf(float x) { return {_mm256_set1_ps(x)}; }
+inline i32 splati(std::int32_t x) { return {_mm256_set1_epi32(x)}; }
+inline i32 laneIndex() { return {_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)}; }
+inline f32 load(const float* p) { return {_mm256_loadu_ps(p)}; }
+inline void store(float* p, f32 a) { _mm256_storeu_ps(p, a.v); }
+inline i32 loadi(const std::int32_t* p) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))}; }
+inline void storei(std::int32_t* p, i32 a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a.v); }
+
+inline f32 operator+(f32 a, f32 b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline f32 operator-(f32 a, f32 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline f32 operator*(f32 a, f32 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline f32 min(f32 a, f32 b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline f32 max(f32 a, f32 b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline f32 floor(f32 a) { return {_mm256_floor_ps(a.v)}; }
+
+inline i32 operator+(i32 a, i32 b) { return {_mm256_add_epi32(a.v, b.v)}; }
+inline i32 operator-(i32 a, i32 b) { return {_mm256_sub_epi32(a.v, b.v)}; }
+inline i32 operator&(i32 a, i32 b) { return {_mm256_and_si256(a.v, b.v)}; }
+inline i32 operator|(i32 a, i32 b) { return {_mm256_or_si256(a.v, b.v)}; }
+inline i32 operator^(i32 a, i32 b) { return {_mm256_xor_si256(a.v, b.v)}; }
+inline i32 operator==(i32 a, i32 b) { return {_mm256_cmpeq_epi32(a.v, b.v)}; }
+inline i32 operator<(i32 a, i32 b) { return {_mm256_cmpgt_epi32(b.v, a.v)}; }
+inline i32 operator*(i32 a, i32 b) { return {_mm256_mullo_epi32(a.v, b.v)}; }
+inline i32 shiftLeft(i32 a, int n) { return {_mm256_slli_epi32(a.v, n)}; }
+inline i32 shiftRight(i32 a, int n) { return {_mm256_srli_epi32(a.v, n)}; }
+
+inline i32 toInt(f32 a) { return {_mm256_cvttps_epi32(a.v)}; }
+inline f32 toFloat(i32 a) { return {_mm256_cvtepi32_ps(a.v)}; }
+inline i32 asInt(f32 a) { return {_mm256_castps_si256(a.v)}; }
+inline f32 asFloat(i32 a) { return {_mm256_castsi256_ps(a.v)}; }
+inline i32 operator<(f32 a, f32 b) { return asInt({_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}); }
+
+// mask ? a : b
+inline f32 select(i32 mask, f32 a, f32 b) { return {_mm256_blendv_ps(b.v, a.v, _mm256_castsi256_ps(mask.v))}; }
+inline i32 select(i32 mask, i32 a, i32 b) { return {_mm256_blendv_epi8(b.v, a.v, mask.v)}; }
+inline bool any(i32 mask) { return _mm256_movemask_ps(_mm256_castsi256_ps(mask.v)) != 0; }
+inline bool all(i32 mask) { return _mm256_movemask_ps(_mm256_castsi256_ps(mask.v)) == 0xFF; }
+
+inline i32 gather(const std::int32_t* table, i32 index) { return {_mm256_i32gather_epi32(table, index.v, 4)}; }
+inline f32 gather(const float* table, i32 index) { return {_mm256_i32gather_ps(table, index.v, 4)}; }
+// table[4 * index + k] of each lane, one vector per k. Eight 16-byte loads
+// and a transpose beat four strided hardware gathers.
+inline void gather4(const float* table, i32 index, f32& a, f32& b, f32& c, f32& d) {
+    alignas(32) std::int32_t idx[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(idx), index.v);
+    __m256 r0 = _mm256_setr_m128(_mm_loadu_ps(table + 4 * idx[0]), _mm_loadu_ps(table + 4 * idx[4]));
+    __m256 r1 = _mm256_setr_m128(_mm_loadu_ps(table + 4 * idx[1]), _mm_loadu_ps(table + 4 * idx[5]));
+    __m256 r2 = _mm256_setr_m128(_mm_loadu_ps(table + 4 * idx[2]), _mm_loadu_ps(table + 4 * idx[6]));
+    __m256 r3 = _mm256_setr_m128(_mm_loadu_ps(table + 4 * idx[3]), _mm_loadu_ps(table + 4 * idx[7]));
+    // 4x4 transpose within each 128-bit half
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    a = {_mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t2)))};
+    b = {_mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t2)))};
+    c = {_mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(t1), _mm256_castps_pd(t3)))};
+    d = {_mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(t1), _mm256_castps_pd(t3)))};
+}
+
+#elif defined(MAPCORE_SIMD_SSE2)
+
+constexpr int width = 4;
+constexpr const char* name = "SSE2";
+
+struct f32 { __m128 v; };
+struct i32 { __m128i v; };
+
+inline f32 splatf(float x) { return {_mm_set1_ps(x)}; }
+inline i32 splati(std::int32_t x) { return {_mm_set1_epi32(x)}; }
+inline i32 laneIndex() { return {_mm_setr_epi32(0, 1, 2, 3)}; }
+inline f32 load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store(float* p, f32 a) { _mm_storeu_ps(p, a.v); }
+inline i32 loadi(const std::int32_t* p) { return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))}; }
+inline void storei(std::int32_t* p, i32 a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a.v); }
+
+inline f32 operator+(f32 a, f32 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline f32 operator-(f32 a, f32 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline f32 operator*(f32 a, f32 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline f32 min(f32 a, f32 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline f32 max(f32 a, f32 b) { return {_mm_max_ps(a.v, b.v)}; }
+
+inline i32 operator+(i32 a, i32 b) { return {_mm_add_epi32(a.v, b.v)}; }
+inline i32 operator-(i32 a, i32 b) { return {_mm_sub_epi32(a.v, b.v)}; }
+inline i32 operator&(i32 a, i32 b) { return {_mm_and_si128(a.v, b.v)}; }
+inline i32 operator|(i32 a, i32 b) { return {_mm_or_si128(a.v, b.v)}; }
+inline i32 operator^(i32 a, i32 b) { return {_mm_xor_si128(a.v, b.v)}; }
+inline i32 operator==(i32 a, i32 b) { return {_mm_cmpeq_epi32(a.v, b.v)}; }
+inline i32 operator<(i32 a, i32 b) { return {_mm_cmplt_epi32(a.v, b.v)}; }
+inline i32 shiftLeft(i32 a, int n) { return {_mm_slli_epi32(a.v, n)}; }
+inline i32 shiftRight(i32 a, int n) { return {_mm_srli_epi32(a.v, n)}; }
+
+// Low 32 bits of the lane products
+inline i32 operator*(i32 a, i32 b) {
+#if defined(__SSE4_1__)
+    return {_mm_mullo_epi32(a.v, b.v)};
+#else
+    const __m128i even = _mm_mul_epu32(a.v, b.v);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a.v, 32), _mm_srli_epi64(b.v, 32));
+    return {_mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                               _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)))};
+#endif
+}
+
+inline i32 toInt(f32 a) { return {_mm_cvttps_epi32(a.v)}; }
+inline f32 toFloat(i32 a) { return {_mm_cvtepi32_ps(a.v)}; }
+inline i32 asInt(f32 a) { return {_mm_castps_si128(a.v)}; }
+inline f32 asFloat(i32 a) { return {_mm_castsi128_ps(a.v)}; }
+inline i32 operator<(f32 a, f32 b) { return asInt({_mm_cmplt_ps(a.v, b.v)}); }
+
+inline f32 select(i32 mask, f32 a, f32 b) {
+    __m128 m = _mm_castsi128_ps(mask.v);
+    return {_mm_or_ps(_mm_and_ps(m, a.v), _mm_andnot_ps(m, b.v))};
+}
+inline i32 select(i32 mask, i32 a, i32 b) {
+    return {_mm_or_si128(_mm_and_si128(mask.v, a.v), _mm_andnot_si128(mask.v, b.v))};
+}
+inline bool any(i32 mask) { return _mm_movemask_ps(_mm_castsi128_ps(mask.v)) != 0; }
+inline bool all(i32 mask) { return _mm_movemask_ps(_mm_castsi128_ps(mask.v)) == 0xF; }
+
+inline f32 floor(f32 a) {
+#if defined(__SSE4_1__)
+    return {_mm_floor_ps(a.v)};
+#else
+    // Truncate, then step down where truncation rounded a negative value up
+    f32 t = toFloat(toInt(a));
+    return select(a < t, t - splatf(1.0f), t);
+#endif
+}
+
+inline i32 gather(const std::int32_t* table, i32 index) {
+    alignas(16) std::int32_t idx[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(idx), index.v);
+    return {_mm_setr_epi32(table[idx[0]], table[idx[1]], table[idx[2]], table[idx[3]])};
+}
+
+inline f32 gather(const float* table, i32 index) {
+    alignas(16) std::int32_t idx[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(idx), index.v);
+    return {_mm_setr_ps(table[idx[0]], table[idx[1]], table[idx[2]], table[idx[3]])};
+}
+
+// One 16-byte load per lane and a transpose instead of sixteen scalar reads
+inline void gather4(const float* table, i32 index, f32& a, f32& b, f32& c, f32& d) {
+    alignas(16) std::int32_t idx[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(idx), index.v);
+    __m128 r0 = _mm_loadu_ps(table + 4 * idx[0]);
+    __m128 r1 = _mm_loadu_ps(table + 4 * idx[1]);
+    __m128 r2 = _mm_loadu_ps(table + 4 * idx[2]);
+    __m128 r3 = _mm_loadu_ps(table + 4 * idx[3]);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    a = {r0};
+    b = {r1};
+    c = {r2};
+    d = {r3};
+}
+
+#else
+
+constexpr int width = 1;
+constexpr const char* name = "scalar";
+
+struct f32 { float v; };
+struct i32 { std::int32_t v; };
+
+inline f32 splatf(float x) { return {x}; }
+inline i32 splati(std::int32_t x) { return {x}; }
+inline i32 laneIndex() { return {0}; }
+inline f32 load(const float* p) { return {*p}; }
+inline void store(float* p, f32 a) { *p = a.v; }
+inline i32 loadi(const std::int32_t* p) { return {*p}; }
+inline void storei(std::int32_t* p, i32 a) { *p = a.v; }
+
+inline f32 operator+(f32 a, f32 b) { return {a.v + b.v}; }
+inline f32 operator-(f32 a, f32 b) { return {a.v - b.v}; }
+inline f32 operator*(f32 a, f32 b) { return {a.v * b.v}; }
+inline f32 min(f32 a, f32 b) { return {b.v < a.v ? b.v : a.v}; }
+inline f32 max(f32 a, f32 b) { return {a.v < b.v ? b.v : a.v}; }
+inline f32 floor(f32 a) { return {std::floor(a.v)}; }
+
+inline i32 operator+(i32 a, i32 b) { return {static_cast<std::int32_t>(static_cast<std::uint32_t>(a.v) + static_cast<std::uint32_t>(b.v))}; }
+inline i32 operator-(i32 a, i32 b) { return {static_cast<std::int32_t>(static_cast<std::uint32_t>(a.v) - static_cast<std::uint32_t>(b.v))}; }
+inline i32 operator&(i32 a, i32 b) { return {a.v & b.v}; }
+inline i32 operator|(i32 a, i32 b) { return {a.v | b.v}; }
+inline i32 operator^(i32 a, i32 b) { return {a.v ^ b.v}; }
+inline i32 operator==(i32 a, i32 b) { return {a.v == b.v ? -1 : 0}; }
+inline i32 operator<(i32 a, i32 b) { return {a.v < b.v ? -1 : 0}; }
+inline i32 operator*(i32 a, i32 b) { return {static_cast<std::int32_t>(static_cast<std::uint32_t>(a.v) * static_cast<std::uint32_t>(b.v))}; }
+inline i32 shiftLeft(i32 a, int n) { return {static_cast<std::int32_t>(static_cast<std::uint32_t>(a.v) << n)}; }
+inline i32 shiftRight(i32 a, int n) { return {static_cast<std::int32_t>(static_cast<std::uint32_t>(a.v) >> n)}; }
+
+inline i32 toInt(f32 a) { return {static_cast<std::int32_t>(a.v)}; }
+inline f32 toFloat(i32 a) { return {static_cast<float>(a.v)}; }
+inline i32 asInt(f32 a) { i32 r; std::memcpy(&r.v, &a.v, 4); return r; }
+inline f32 asFloat(i32 a) { f32 r; std::memcpy(&r.v, &a.v, 4); return r; }
+inline i32 operator<(f32 a, f32 b) { return {a.v < b.v ? -1 : 0}; }
+
+inline f32 select(i32 mask, f32 a, f32 b) { return mask.v ? a : b; }
+inline i32 select(i32 mask, i32 a, i32 b) { return mask.v ? a : b; }
+inline bool any(i32 mask) { return mask.v != 0; }
+inline bool all(i32 mask) { return mask.v != 0; }
+
+inline i32 gather(const std::int32_t* table, i32 index) { return {table[index.v]}; }
+inline f32 gather(const float* table, i32 index) { return {table[index.v]}; }
+inline void gather4(const float* table, i32 index, f32& a, f32& b, f32& c, f32& d) {
+    const float* q = table + 4 * index.v;
+    a = {q[0]};
+    b = {q[1]};
+    c = {q[2]};
+    d = {q[3]};
+}
+
+#endif
+
+// Shared helpers built on the primitives above
+
+inline f32 operator-(f32 a) { return asFloat(asInt(a) ^ splati(INT32_MIN)); }
+inline f32 abs(f32 a) { return asFloat(asInt(a) & splati(INT32_MAX)); }
+
+// Flips the sign of the lanes whose bit 31 is set in signBits
+inline f32 flipSign(f32 a, i32 signBits) { return asFloat(asInt(a) ^ signBits); }
+
+// Stores the first count lanes of a (count <= width)
+inline void storePartial(float* p, f32 a, int count) {
+    alignas(32) float tmp[width];
+    store(tmp, a);
+    std::memcpy(p, tmp, sizeof(float) * count);
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "MapGenerator.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Pre-generates the maps the editor is most likely to ask for next: seed
+// + 1, seed - 1, and one octave more or fewer than the map on screen. One
+// background thread builds them outside the thread pool (see
+// ThreadPool::SerialScope), reusing the stages of the current map, and
+// keeps them until speculation moves elsewhere. Call cancel() before
+// starting real work, then take() a ready map if there is one.
+class SpeculativeGenerator {
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    bool hasCenter = false;
+    MapParams center;
+    StageCache centerStages;
+    std::vector<MapParams> queue;  // next to generate first
+    std::shared_ptr<GenerationProgress> active;
+    MapParams activeParams;
+    std::vector<std::pair<MapParams, std::unique_ptr<MapGenerator>>> ready;
+
+    void workerLoop();
+
+public:
+    // Octave range of the editor's slider; speculation stays inside it
+    static constexpr int minOctaves = 1;
+    static constexpr int maxOctaves = 16;
+
+    SpeculativeGenerator();
+    ~SpeculativeGenerator();
+    SpeculativeGenerator(const SpeculativeGenerator&) = delete;
+    SpeculativeGenerator& operator=(const SpeculativeGenerator&) = delete;
+
+    // Likely next parameters after params, most likely first
+    static std::vector<MapParams> neighbours(const MapParams& params);
+
+    // Speculates around params, the map now shown, built from stages.
+    // Ready maps that are not neighbours of params are dropped.
+    void speculate(const MapParams& params, StageCache stages);
+    // True when speculating around params and not cancelled since
+    bool isAround(const MapParams& params);
+    // Abandons the map in progress and stops until the next speculate().
+    // Ready maps are kept for take().
+    void cancel();
+    // The ready map for params, or nullptr
+    std::unique_ptr<MapGenerator> take(const MapParams& params);
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Tiles store a one byte id into the terrain type table instead of an
+// allocated Terrain object. Grass keeps its value by using one id per value.
+using TerrainId = std::uint8_t;
+
+struct TerrainType {
+    char symbol;
+    unsigned char r, g, b;
+};
+
+class Terrain {
+public:
+    static constexpr TerrainId Water = 0;
+    static constexpr TerrainId Beach = 1;
+    static constexpr TerrainId Stone = 2;
+    static constexpr TerrainId GrassBase = 3;  // Grass with value v is GrassBase + v
+    static constexpr int maxGrassValue = 10;
+    // Biomes, placed by moisture and temperature (MapParams::biomes)
+    static constexpr TerrainId Snow = GrassBase + maxGrassValue + 1;
+    static constexpr TerrainId Tundra = Snow + 1;
+    static constexpr TerrainId Taiga = Snow + 2;
+    static constexpr TerrainId Forest = Snow + 3;
+    static constexpr TerrainId Jungle = Snow + 4;
+    static constexpr TerrainId Savanna = Snow + 5;
+    static constexpr TerrainId Desert = Snow + 6;
+    static constexpr int typeCount = Desert + 1;
+
+    static TerrainId grass(int value);
+    static bool isGrass(TerrainId id) { return id >= GrassBase && id <= GrassBase + maxGrassValue; }
+    static int grassValue(TerrainId id) { return id - GrassBase; }
+
+    static const TerrainType& type(TerrainId id);
+    static char getSymbol(TerrainId id) { return type(id).symbol; }
+    static void getColor(TerrainId id, unsigned char& r, unsigned char& g, unsigned char& b);
+
+    // 256 packed RGB entries indexed by TerrainId (unused ids are black),
+    // for resolving an index texture on the GPU
+    static void generatePalette(std::vector<unsigned char>& data);
+};
+
+class TerrainTile {
+public:
+    TerrainId id;
+    TerrainTile(TerrainId t = Terrain::Water) : id(t) {}
+    char getSymbol() const { return Terrain::getSymbol(id); }
+    void getColor(unsigned char& r, unsigned char& g, unsigned char& b) const { Terrain::getColor(id, r, g, b); }
+};
+
+// The grid is uploaded as-is as a one byte per texel index texture
+static_assert(sizeof(TerrainTile) == 1, "TerrainTile must stay a single byte");
@@ -0,0 +1,79 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads running parallelFor loops.
+// Work is split into fixed chunks of `grain` items that each write their
+// own output, so results never depend on how many threads take part.
+// parallelFor does not allocate; the calling thread works too.
+class ThreadPool {
+    struct Job {
+        void (*invoke)(void* fn, int begin, int end);
+        void* fn;
+        int count;
+        int grain;
+        std::atomic<int> nextChunk{0};
+        int active = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::mutex submitMutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    Job* current = nullptr;
+    std::uint64_t generation = 0;
+    bool stopping = false;
+
+    void workerLoop();
+    void run(Job& job);
+    static void work(Job& job);
+
+public:
+    // threadCount includes the calling thread; 0 uses every hardware thread
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Calls fn(begin, end) for consecutive ranges covering [0, count).
+    // Nested calls, and calls made while another thread is using the pool,
+    // run inline on the calling thread.
+    template <class F>
+    void parallelFor(int count, int grain, F&& fn) {
+        if (count <= 0) return;
+        Job job;
+        job.invoke = [](void* f, int begin, int end) { (*static_cast<std::remove_reference_t<F>*>(f))(begin, end); };
+        job.fn = const_cast<void*>(static_cast<const void*>(&fn));
+        job.count = count;
+        job.grain = std::max(grain, 1);
+        run(job);
+    }
+
+    // While one is alive, parallelFor calls made on its thread run inline.
+    // Background work uses it so it never holds the workers when
+    // foreground generation arrives.
+    class SerialScope {
+        bool saved;
+
+    public:
+        SerialScope();
+        ~SerialScope();
+        SerialScope(const SerialScope&) = delete;
+        SerialScope& operator=(const SerialScope&) = delete;
+    };
+
+    // Pool shared by the generators
+    static ThreadPool& shared();
+    // Recreates the shared pool; only call while no generation is running
+    static void setSharedThreadCount(int threadCount);
+};
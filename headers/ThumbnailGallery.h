@@ -0,0 +1,59 @@
+#pragma once
+#include "MapGenerator.h"
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Low resolution maps of many seeds for picking one. A background thread
+// generates the requested thumbnails in batches across the shared thread
+// pool, in request order, and keeps them in an LRU cache keyed by their
+// parameters (seed included), so paging back to seen seeds is instant.
+class ThumbnailGallery {
+public:
+    using Thumbnail = std::shared_ptr<const Grid2D<TerrainTile>>;
+
+    // size: longer side of a thumbnail in tiles; capacity: thumbnails kept
+    explicit ThumbnailGallery(int size = 96, int capacity = 1024);
+    ~ThumbnailGallery();
+    ThumbnailGallery(const ThumbnailGallery&) = delete;
+    ThumbnailGallery& operator=(const ThumbnailGallery&) = delete;
+
+    // Replaces the wanted thumbnails: seeds of params, first needed first.
+    // Already cached ones are skipped.
+    void request(const MapParams& params, const std::vector<unsigned int>& seeds);
+    // Thumbnail of params (its seed included), or nullptr until generated
+    Thumbnail find(const MapParams& params);
+    // A paused gallery finishes its batch and leaves the pool to full size
+    // generation until resumed
+    void setPaused(bool paused);
+    // True while requested thumbnails are missing
+    bool isBusy();
+    int getSize() const { return size; }
+
+private:
+    struct Entry {
+        MapParams key;
+        Thumbnail tiles;
+    };
+
+    const int size;
+    const int capacity;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    bool paused = false;
+
+    std::vector<MapParams> wanted;  // downscaled, first needed first
+    std::size_t nextWanted = 0;
+    bool generating = false;
+    std::list<Entry> entries;  // most recently used first
+    std::unordered_map<MapParams, std::list<Entry>::iterator, MapParamsHash> index;
+
+    void workerLoop();
+    void insert(const MapParams& key, Thumbnail tiles);
+};
@@ -0,0 +1,95 @@
+#include "../headers/AsyncGenerator.h"
+
+AsyncGenerator::AsyncGenerator() : worker(&AsyncGenerator::workerLoop, this) {}
+
+AsyncGenerator::~AsyncGenerator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        hasPending = false;
+        pendingStages = StageCache();
+        if (active) active->cancelled = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void AsyncGenerator::request(const MapParams& params, StageCache reuse) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = params;
+        pendingStages = std::move(reuse);
+        hasPending = true;
+        if (active) active->cancelled = true;
+    }
+    wake.notify_all();
+}
+
+void AsyncGenerator::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    hasPending = false;
+    pendingStages = StageCache();
+    preview.reset();
+    if (active) active->cancelled = true;
+}
+
+bool AsyncGenerator::isBusy() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hasPending || active;
+}
+
+MapParams AsyncGenerator::getRequested() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hasPending ? pending : activeParams;
+}
+
+float AsyncGenerator::getProgress() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return active ? active->fraction() : 0.0f;
+}
+
+std::unique_ptr<MapGenerator> AsyncGenerator::takeResult() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::move(finished);
+}
+
+std::unique_ptr<Grid2D<TerrainTile>> AsyncGenerator::takePreview() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::move(preview);
+}
+
+void AsyncGenerator::workerLoop() {
+    for (;;) {
+        MapParams params;
+        StageCache stages;
+        std::shared_ptr<GenerationProgress> progress;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || hasPending; });
+            if (stopping) return;
+            params = pending;
+            stages = std::move(pendingStages);
+            pendingStages = StageCache();
+            hasPending = false;
+            progress = std::make_shared<GenerationProgress>();
+            GenerationProgress* watched = progress.get();
+            progress->onPreview = [this, watched](const MapGenerator& map, int) {
+                auto grid = std::make_unique<Grid2D<TerrainTile>>(map.getGrid());
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!watched->cancelled) preview = std::move(grid);
+            };
+            active = progress;
+            activeParams = params;
+        }
+
+        auto map = std::make_unique<MapGenerator>(params, progress.get(), &stages);
+
+        // Also drops a map that finished just as a newer request cancelled it
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!progress->cancelled) {
+            finished = std::move(map);
+            preview.reset();
+        }
+        active.reset();
+    }
+}
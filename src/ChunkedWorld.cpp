@@ -0,0 +1,168 @@
+#include "../headers/ChunkedWorld.h"
+#include "../headers/ThreadPool.h"
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+// Rows per parallelFor chunk, as in MapGenerator
+static const int bandRows = 8;
+
+ChunkedWorld::ChunkedWorld(const MapParams& params, int chunkSize, int capacity)
+    : params(params), chunkSize(std::max(chunkSize, 1)), capacity(std::max(capacity, 1)),
+      octaveTable(params.octaves, params.persistence, params.lacunarity),
+      noise(params.seed, params.noiseType, params.fractal) {}
+
+void ChunkedWorld::generateChunk(Chunk& chunk) {
+    const int x0 = chunk.cx * chunkSize;
+    const int y0 = chunk.cy * chunkSize;
+    const int w = std::min(chunkSize, params.width - x0);
+    const int h = std::min(chunkSize, params.height - y0);
+    chunk.tiles.resize(w, h);
+
+    // Same arithmetic as MapGenerator's noise, combine and classify stages
+    // (or its fused field pass)
+    const bool cliffs = params.cliffSlope > 0.0f;
+    const bool fieldPass = params.biomes || cliffs;
+    const int climate = params.biomes ? std::min(octaveTable.count, MapGenerator::climateOctaves) : 0;
+    const int counts[] = {octaveTable.count, climate, climate};
+    const int fieldCount = params.biomes ? 3 : 1;
+    const float climateScale = MapGenerator::climateScale(octaveTable);
+
+    ThreadPool::shared().parallelFor(h, bandRows, [&](int begin, int end) {
+        std::vector<float> sums(w), moisture(w), temperature(w), dx, dy;
+        if (cliffs) {
+            dx.resize(w);
+            dy.resize(w);
+        }
+        float* const fields[] = {sums.data(), moisture.data(), temperature.data()};
+        for (int r = begin; r < end; ++r) {
+            const int y = y0 + r;
+            if (fieldPass) {
+                noise.fieldsRow(fields, counts, fieldCount, x0, w, y, params.baseScale, octaveTable,
+                                cliffs ? dx.data() : nullptr, cliffs ? dy.data() : nullptr);
+            } else {
+                noise.fractalRow(sums.data(), x0, w, y, params.baseScale, octaveTable);
+            }
+            TerrainTile* row = chunk.tiles.row(r);
+            for (int i = 0; i < w; ++i) {
+                float noiseHeight = (sums[i] + 1) / 2.0f;
+                float falloff = MapGenerator::falloffAt(x0 + i, y, params.width, params.height, params.islandScale);
+                TerrainId id;
+                if (params.biomes) {
+                    id = MapGenerator::generateBiome(noiseHeight * falloff, 0.5f + moisture[i] * climateScale,
+                                                     0.5f + temperature[i] * climateScale);
+                } else {
+                    id = MapGenerator::generateTerrainFromHeight(noiseHeight * falloff);
+                }
+                if (cliffs && id != Terrain::Water &&
+                    MapGenerator::slopeAt(x0 + i, y, params.width, params.height, params.islandScale, sums[i], dx[i],
+                                          dy[i]) > params.cliffSlope) {
+                    id = Terrain::Stone;
+                }
+                row[i].id = id;
+            }
+        }
+    });
+
+    auto edited = edits.find(key(chunk.cx, chunk.cy));
+    if (edited != edits.end()) {
+        for (const auto& [offset, terrain] : edited->second) {
+            chunk.tiles(offset % chunkSize, offset / chunkSize).id = terrain;
+        }
+    }
+}
+
+const Grid2D<TerrainTile>& ChunkedWorld::getChunk(int cx, int cy) {
+    const std::int64_t k = key(cx, cy);
+    auto found = index.find(k);
+    if (found != index.end()) {
+        ++stats.hits;
+        chunks.splice(chunks.begin(), chunks, found->second);
+        return found->second->tiles;
+    }
+
+    ++stats.misses;
+    if (static_cast<int>(chunks.size()) >= capacity) {
+        // Recycle the least recently used chunk and its tile storage
+        ++stats.evictions;
+        index.erase(key(chunks.back().cx, chunks.back().cy));
+        chunks.splice(chunks.begin(), chunks, std::prev(chunks.end()));
+    } else {
+        chunks.emplace_front();
+    }
+    Chunk& chunk = chunks.front();
+    chunk.cx = cx;
+    chunk.cy = cy;
+    generateChunk(chunk);
+    index[k] = chunks.begin();
+    return chunk.tiles;
+}
+
+void ChunkedWorld::touch(const DirtyRect& rect) {
+    const int cx0 = std::max(rect.x0, 0) / chunkSize;
+    const int cy0 = std::max(rect.y0, 0) / chunkSize;
+    const int cx1 = std::min((std::min(rect.x1, params.width) + chunkSize - 1) / chunkSize, chunksX());
+    const int cy1 = std::min((std::min(rect.y1, params.height) + chunkSize - 1) / chunkSize, chunksY());
+    for (int cy = cy0; cy < cy1; ++cy) {
+        for (int cx = cx0; cx < cx1; ++cx) {
+            getChunk(cx, cy);
+        }
+    }
+}
+
+TerrainId ChunkedWorld::getTerrain(int x, int y) {
+    if (x < 0 || x >= params.width || y < 0 || y >= params.height) return Terrain::Water;
+    return getChunk(x / chunkSize, y / chunkSize)(x % chunkSize, y % chunkSize).id;
+}
+
+void ChunkedWorld::setTerrain(int x, int y, TerrainId terrain) {
+    if (x < 0 || x >= params.width || y < 0 || y >= params.height) return;
+    const int cx = x / chunkSize;
+    const int cy = y / chunkSize;
+    edits[key(cx, cy)][(y % chunkSize) * chunkSize + x % chunkSize] = terrain;
+    auto found = index.find(key(cx, cy));
+    if (found != index.end()) found->second->tiles(x % chunkSize, y % chunkSize).id = terrain;
+}
+
+void ChunkedWorld::setCapacity(int chunkCount) {
+    capacity = std::max(chunkCount, 1);
+    while (static_cast<int>(chunks.size()) > capacity) {
+        ++stats.evictions;
+        index.erase(key(chunks.back().cx, chunks.back().cy));
+        chunks.pop_back();
+    }
+}
+
+bool ChunkedWorld::exportToPPM(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "P3\n" << params.width << " " << params.height << "\n255\n";
+    // A full row of chunks has to stay resident while its rows are written
+    const int savedCapacity = capacity;
+    capacity = std::max(capacity, chunksX());
+    std::vector<const Grid2D<TerrainTile>*> band(chunksX());
+    for (int cy = 0; cy < chunksY(); ++cy) {
+        for (int cx = 0; cx < chunksX(); ++cx) {
+            band[cx] = &getChunk(cx, cy);
+        }
+        const int rows = band[0]->height();
+        for (int r = 0; r < rows; ++r) {
+            for (const Grid2D<TerrainTile>* tiles : band) {
+                const TerrainTile* row = tiles->row(r);
+                for (int i = 0; i < tiles->width(); ++i) {
+                    const TerrainType& t = Terrain::type(row[i].id);
+                    file << static_cast<int>(t.r) << " "
+                         << static_cast<int>(t.g) << " "
+                         << static_cast<int>(t.b) << " ";
+                }
+            }
+            file << "\n";
+        }
+    }
+    setCapacity(savedCapacity);
+    file.close();
+    return true;
+}
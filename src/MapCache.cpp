@@ -0,0 +1,46 @@
+#include "../headers/MapCache.h"
+
+MapCache::MapCache(std::size_t budgetBytes) : budget(budgetBytes) {}
+
+void MapCache::put(const MapGenerator& map) {
+    // A map larger than the whole budget is not kept, and not copied
+    const std::size_t size = map.memoryBytes();
+    if (size > budget) return;
+    const MapParams params = map.getParams();
+    auto found = index.find(params);
+    if (found != index.end()) {
+        bytes -= found->second->bytes;
+        entries.erase(found->second);
+        index.erase(found);
+    }
+    // Make room first, so the copy never briefly exceeds the budget
+    trim(budget - size);
+    entries.push_front({params, std::make_unique<MapGenerator>(map), size});
+    index[params] = entries.begin();
+    bytes += size;
+}
+
+std::unique_ptr<MapGenerator> MapCache::find(const MapParams& params) {
+    auto found = index.find(params);
+    if (found == index.end()) {
+        ++stats.misses;
+        return nullptr;
+    }
+    ++stats.hits;
+    entries.splice(entries.begin(), entries, found->second);
+    return std::make_unique<MapGenerator>(*found->second->map);
+}
+
+void MapCache::setBudget(std::size_t budgetBytes) {
+    budget = budgetBytes;
+    trim(budget);
+}
+
+void MapCache::trim(std::size_t limit) {
+    while (bytes > limit && !entries.empty()) {
+        ++stats.evictions;
+        bytes -= entries.back().bytes;
+        index.erase(entries.back().params);
+        entries.pop_back();
+    }
+}
@@ -0,0 +1,643 @@
+#include "../headers/MapGenerator.h"
+#include "../headers/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <cstring>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "../stb_image_write/stb-master/stb_image_write.h"
+
+
+// Rows per parallelFor chunk. Every row is computed independently, so the
+// output is bit-identical for any thread count.
+static const int bandRows = 8;
+
+void DirtyRect::add(int x, int y) {
+    add(DirtyRect{x, y, x + 1, y + 1});
+}
+
+void DirtyRect::add(const DirtyRect& other) {
+    if (other.empty()) return;
+    if (empty()) {
+        *this = other;
+        return;
+    }
+    x0 = std::min(x0, other.x0);
+    y0 = std::min(y0, other.y0);
+    x1 = std::max(x1, other.x1);
+    y1 = std::max(y1, other.y1);
+}
+
+bool MapGenerator::getIsDirty() const { return isDirty; }
+void MapGenerator::markClean() {
+    isDirty = false;
+    dirtyRect = DirtyRect();
+}
+bool MapGenerator::isCancelled() const {
+    return progress && progress->cancelled.load(std::memory_order_relaxed);
+}
+
+void MapGenerator::addProgress(long long work) {
+    if (progress) progress->workDone.fetch_add(work, std::memory_order_relaxed);
+}
+
+// Layers shared with another generator are replaced, never written through
+static Grid2D<float>& ensureUnique(std::shared_ptr<Grid2D<float>>& layer) {
+    if (!layer || layer.use_count() > 1) layer = std::make_shared<Grid2D<float>>();
+    return *layer;
+}
+
+// Band loops use these rather than local vectors. Sized up front for every
+// chunk, so a regeneration at an unchanged size allocates nothing however
+// many threads share the work.
+void MapGenerator::reserveScratch(int rowWidth, int rows, int slots) {
+    scratch.slots = slots;
+    scratch.rows.resize(rowWidth, (rows + bandRows - 1) / bandRows * slots);
+}
+
+float* MapGenerator::scratchRow(int begin, int slot) {
+    return scratch.rows.row(begin / bandRows * scratch.slots + slot);
+}
+
+Grid2D<float>& MapGenerator::freshLayer(std::shared_ptr<Grid2D<float>>& layer) {
+    if (layer && layer.use_count() == 1) return *layer;
+    // Copies of this map share its spares; those are left to the other copy
+    while (!spareLayers.empty()) {
+        std::shared_ptr<Grid2D<float>> spare = std::move(spareLayers.back());
+        spareLayers.pop_back();
+        if (spare.use_count() == 1) {
+            layer = std::move(spare);
+            return *layer;
+        }
+    }
+    layer = std::make_shared<Grid2D<float>>();
+    return *layer;
+}
+
+void MapGenerator::retireLayer(std::shared_ptr<Grid2D<float>>& layer) {
+    if (layer && layer.use_count() == 1) spareLayers.push_back(std::move(layer));
+    layer.reset();
+}
+
+float MapGenerator::falloffAt(int x, int y, int width, int height, float islandScale) {
+    const float centerX = (width - 1) / 2.0f;
+    const float centerY = (height - 1) / 2.0f;
+    float dx = (x - centerX) / (centerX * islandScale);
+    float dy = (y - centerY) / (centerY * islandScale);
+    float distance = std::sqrt(dx*dx + dy*dy);
+
+    distance = std::clamp(distance, 0.0f, 1.0f);
+    distance = distance * distance * (3.0f - 2.0f * distance);
+    return 1.0f - distance;
+}
+
+float MapGenerator::slopeAt(int x, int y, int width, int height, float islandScale, float sum, float dx, float dy) {
+    const float centerX = (width - 1) / 2.0f;
+    const float centerY = (height - 1) / 2.0f;
+    const float rx = (x - centerX) / (centerX * islandScale);
+    const float ry = (y - centerY) / (centerY * islandScale);
+    const float distance = std::sqrt(rx*rx + ry*ry);
+
+    // falloff = 1 - smoothstep(distance), so d falloff / dx = -6 (1 - d) rx / (centerX * islandScale)
+    float falloff = 0.0f, falloffDx = 0.0f, falloffDy = 0.0f;
+    if (distance < 1.0f) {
+        falloff = 1.0f - distance * distance * (3.0f - 2.0f * distance);
+        falloffDx = -6.0f * (1.0f - distance) * rx / (centerX * islandScale);
+        falloffDy = -6.0f * (1.0f - distance) * ry / (centerY * islandScale);
+    }
+    // Height is (sum + 1) / 2 * falloff
+    const float noiseHeight = (sum + 1) / 2.0f;
+    const float gx = 0.5f * dx * falloff + noiseHeight * falloffDx;
+    const float gy = 0.5f * dy * falloff + noiseHeight * falloffDy;
+    return std::sqrt(gx*gx + gy*gy);
+}
+
+void  MapGenerator::generateFalloffMap() {
+    Grid2D<float>& falloffMap = ensureUnique(falloffLayer);
+    falloffMap.resize(width, height);
+
+    ThreadPool::shared().parallelFor(height, bandRows, [&](int begin, int end) {
+        if (isCancelled()) return;
+        for (int y = begin; y < end; ++y) {
+            float* row = falloffMap.row(y);
+            for (int x = 0; x < width; ++x) {
+                row[x] = falloffAt(x, y, width, height, islandScale);
+            }
+        }
+        addProgress(static_cast<long long>(end - begin) * width);
+    });
+}
+
+
+void MapGenerator::generateNoiseMap() {
+    const OctaveTable octaveTable(octaves, persistence, lacunarity);
+    const int count = octaveTable.count;
+    if (static_cast<int>(octaveSums.size()) <= count) octaveSums.resize(count + 1);
+
+    const int start = cachedOctaves(count);
+    if (start == count) {
+        // Every octave is already summed in a cached prefix, or there are
+        // none: then the sum is a flat zero layer
+        if (!octaveSums[count]) {
+            Grid2D<float>& zero = freshLayer(octaveSums[count]);
+            zero.resize(width, height);
+            zero.fill(0.0f);
+        }
+        return;
+    }
+
+    const std::size_t layerBytes = static_cast<std::size_t>(width) * height * sizeof(float);
+    const bool keepPrefixes = layerBytes * (count + 1) <= octaveCacheBytes;
+    const int firstNew = keepPrefixes ? start + 1 : count;
+    for (int k = firstNew; k <= count; ++k) {
+        freshLayer(octaveSums[k]).resize(width, height);
+    }
+    const Grid2D<float>* base = start > 0 ? octaveSums[start].get() : nullptr;
+
+    // Progressive generation fills ever finer lattices, previewStep, then
+    // half that, down to 1 tile apart, with a preview after each coarse level.
+    // Every sample is computed once, exactly as in a single full pass.
+    const bool progressive = progress && progress->onPreview;
+    const int coarsest = progressive ? previewStep : 1;
+    if (progressive) {
+        grid.resize(width, height);
+        reserveScratch(width, height, 2);
+    }
+
+    for (int step = coarsest; step >= 1; step /= 2) {
+        const int levelRows = (height + step - 1) / step;
+        ThreadPool::shared().parallelFor(levelRows, bandRows, [&](int begin, int end) {
+            if (isCancelled()) return;
+            long long samples = 0;
+            for (int r = begin; r < end; ++r) {
+                const int y = r * step;
+                // Rows already visited by the coarser level only need the new columns
+                const bool revisit = step < coarsest && y % (2 * step) == 0;
+                const int x0 = revisit ? step : 0;
+                const int xStep = revisit ? 2 * step : step;
+                if (x0 >= width) continue;
+                const int n = (width - 1 - x0) / xStep + 1;
+                samples += n;
+
+                if (xStep == 1) {
+                    const float* prev = base ? base->row(y) : nullptr;
+                    if (keepPrefixes) {
+                        for (int k = start; k < count; ++k) {
+                            float* sum = octaveSums[k + 1]->row(y);
+                            noise.octaveRow(sum, prev, 0, width, y, baseScale, octaveTable, k, k + 1);
+                            prev = sum;
+                        }
+                    } else {
+                        noise.octaveRow(octaveSums[count]->row(y), prev, 0, width, y, baseScale, octaveTable, start, count);
+                    }
+                    continue;
+                }
+
+                // Strided samples go through contiguous scratch rows
+                float* out = scratchRow(begin, 0);
+                const float* prev = nullptr;
+                if (base) {
+                    float* in = scratchRow(begin, 1);
+                    const float* src = base->row(y);
+                    for (int i = 0; i < n; ++i) in[i] = src[x0 + i * xStep];
+                    prev = in;
+                }
+                const int first = keepPrefixes ? start : count - 1;
+                for (int k = first; k < count; ++k) {
+                    const int from = keepPrefixes ? k : start;
+                    noise.octaveRow(out, prev, x0, n, y, baseScale, octaveTable, from, k + 1, xStep);
+                    float* dst = octaveSums[k + 1]->row(y);
+                    for (int i = 0; i < n; ++i) dst[x0 + i * xStep] = out[i];
+                    prev = out;
+                }
+            }
+            addProgress(samples * (count - start));
+        });
+        if (isCancelled()) break;
+        if (step > 1) previewLevel(*octaveSums[count], step);
+    }
+
+    // Layers left partial by cancellation must not be reused
+    if (isCancelled()) {
+        for (int k = firstNew; k <= count; ++k) retireLayer(octaveSums[k]);
+    } else if (!keepPrefixes) {
+        for (int k = 0; k < count; ++k) retireLayer(octaveSums[k]);
+    }
+}
+
+// Classifies the samples of one progressive level and fills each one's
+// step x step block of the grid with the result
+void MapGenerator::previewLevel(const Grid2D<float>& sums, int step) {
+    const int levelRows = (height + step - 1) / step;
+    ThreadPool::shared().parallelFor(levelRows, bandRows, [&](int begin, int end) {
+        for (int r = begin; r < end; ++r) {
+            const int y = r * step;
+            const float* raw = sums.row(y);
+            const float* falloff = falloffLayer->row(y);
+            TerrainTile* row = grid.row(y);
+            for (int x = 0; x < width; x += step) {
+                float noiseHeight = (raw[x] + 1) / 2.0f;
+                const TerrainId id = generateTerrainFromHeight(noiseHeight * falloff[x]);
+                std::fill(row + x, row + std::min(x + step, width), TerrainTile(id));
+            }
+            for (int dy = 1; dy < step && y + dy < height; ++dy) {
+                std::copy(row, row + width, grid.row(y + dy));
+            }
+        }
+    });
+    progress->onPreview(*this, step);
+}
+
+void MapGenerator::combineLayers() {
+    const Grid2D<float>& noiseMap = *octaveSums[OctaveTable(octaves, persistence, lacunarity).count];
+    heightMap.resize(width, height);
+    ThreadPool::shared().parallelFor(height, bandRows, [&](int begin, int end) {
+        if (isCancelled()) return;
+        for (int i = begin; i < end; ++i) {
+            float* row = heightMap.row(i);
+            const float* raw = noiseMap.row(i);
+            const float* falloff = falloffLayer->row(i);
+            for (int j = 0; j < width; ++j) {
+                float noiseHeight = (raw[j] + 1) / 2.0f;
+                row[j] = noiseHeight * falloff[j];
+            }
+        }
+        addProgress(static_cast<long long>(end - begin) * width);
+    });
+}
+
+// Every height where generateTerrainFromHeight changes its result
+static const float terrainCuts[] = {0.3f, 0.35f, 0.4f, 0.5f, 0.6f, 0.7f};
+
+TerrainId MapGenerator::generateTerrainFromHeight(float h) {
+    if (h < 0.3f) return Terrain::Water;
+    if (h < 0.35f) return Terrain::Beach;
+    if (h < 0.7f) return Terrain::grass(static_cast<int>(h * 10));
+    return Terrain::Stone;
+}
+
+void MapGenerator::classifyTerrain() {
+    grid.resize(width, height);
+    ThreadPool::shared().parallelFor(height, bandRows, [&](int begin, int end) {
+        if (isCancelled()) return;
+        for (int i = begin; i < end; ++i) {
+            TerrainTile* row = grid.row(i);
+            const float* heights = heightMap.row(i);
+            for (int j = 0; j < width; ++j) {
+                row[j].id = generateTerrainFromHeight(heights[j]);
+            }
+        }
+        addProgress(static_cast<long long>(end - begin) * width);
+    });
+}
+
+// Fused noise and classify pass with per-tile octave early-out
+void MapGenerator::classifyDecided() {
+    const OctaveTable octaveTable(octaves, persistence, lacunarity);
+    const int cutCount = static_cast<int>(sizeof(terrainCuts) / sizeof(terrainCuts[0]));
+    grid.resize(width, height);
+    reserveScratch(width, height, 1);
+    ThreadPool::shared().parallelFor(height, bandRows, [&](int begin, int end) {
+        if (isCancelled()) return;
+        float* sums = scratchRow(begin, 0);
+        for (int i = begin; i < end; ++i) {
+            const float* falloff = falloffLayer->row(i);
+            noise.decidedRow(sums, 0, width, i, baseScale, octaveTable, falloff, terrainCuts, cutCount);
+            TerrainTile* row = grid.row(i);
+            for (int j = 0; j < width; ++j) {
+                float noiseHeight = (sums[j] + 1) / 2.0f;
+                row[j].id = generateTerrainFromHeight(noiseHeight * falloff[j]);
+            }
+        }
+        addProgress(static_cast<long long>(end - begin) * width * (octaveTable.count + 1));
+    });
+}
+
+// Temperature and moisture bands of the biome table
+static const float coldBelow = 0.43f;
+static const float hotFrom = 0.53f;
+static const float dryBelow = 0.46f;
+static const float wetFrom = 0.54f;
+// Temperature lost per unit of height above the beach
+static const float lapseRate = 0.3f;
+
+// Land biomes by temperature band (cold to hot) and moisture band (dry to
+// wet). GrassBase stands for grass shaded by height, as on plain maps.
+static const TerrainId biomeTable[3][3] = {
+    {Terrain::Tundra, Terrain::Taiga, Terrain::Taiga},
+    {Terrain::GrassBase, Terrain::GrassBase, Terrain::Forest},
+    {Terrain::Desert, Terrain::Savanna, Terrain::Jungle},
+};
+
+float MapGenerator::climateScale(const OctaveTable& octaves) {
+    // Normalized by the total amplitude of the climate octaves
+    float amplitude = 0.0f;
+    for (int o = 0; o < std::min(octaves.count, climateOctaves); ++o) amplitude += std::fabs(octaves.amplitude[o]);
+    return amplitude > 0.0f ? 0.5f / amplitude : 0.0f;
+}
+
+TerrainId MapGenerator::generateBiome(float h, float moisture, float temperature) {
+    if (h < 0.3f) return Terrain::Water;
+    if (h < 0.35f) return Terrain::Beach;
+    temperature -= (h - 0.35f) * lapseRate;
+    if (h >= 0.7f) return temperature < coldBelow ? Terrain::Snow : Terrain::Stone;
+    const int t = temperature < coldBelow ? 0 : temperature < hotFrom ? 1 : 2;
+    const int m = moisture < dryBelow ? 0 : moisture < wetFrom ? 1 : 2;
+    const TerrainId id = biomeTable[t][m];
+    return id == Terrain::GrassBase ? Terrain::grass(static_cast<int>(h * 10)) : id;
+}
+
+// Fused noise, combine and classify pass of biome and cliff maps: elevation,
+// its gradient and the climate fields come from one multi-field row evaluation
+void MapGenerator::generateFieldMap() {
+    const OctaveTable octaveTable(octaves, persistence, lacunarity);
+    const int climate = biomes ? std::min(octaveTable.count, climateOctaves) : 0;
+    const int counts[] = {octaveTable.count, climate, climate};
+    const int fieldCount = biomes ? 3 : 1;
+    const float scale = climateScale(octaveTable);
+    const bool cliffs = cliffSlope > 0.0f;
+
+    grid.resize(width, height);
+    if (classifyOnly) heightMap.resize(0, 0);
+    else heightMap.resize(width, height);
+    reserveScratch(width, height, cliffs ? 5 : 3);
+    ThreadPool::shared().parallelFor(height, bandRows, [&](int begin, int end) {
+        if (isCancelled()) return;
+        float* const elevation = scratchRow(begin, 0);
+        float* const moisture = scratchRow(begin, 1);
+        float* const temperature = scratchRow(begin, 2);
+        float* const dx = cliffs ? scratchRow(begin, 3) : nullptr;
+        float* const dy = cliffs ? scratchRow(begin, 4) : nullptr;
+        float* const fields[] = {elevation, moisture, temperature};
+        for (int i = begin; i < end; ++i) {
+            noise.fieldsRow(fields, counts, fieldCount, 0, width, i, baseScale, octaveTable, dx, dy);
+            const float* falloff = falloffLayer->row(i);
+            float* heights = classifyOnly ? nullptr : heightMap.row(i);
+            TerrainTile* row = grid.row(i);
+            for (int j = 0; j < width; ++j) {
+                float noiseHeight = (elevation[j] + 1) / 2.0f;
+                const float h = noiseHeight * falloff[j];
+                if (heights) heights[j] = h;
+                TerrainId id = biomes ? generateBiome(h, 0.5f + moisture[j] * scale, 0.5f + temperature[j] * scale)
+                                      : generateTerrainFromHeight(h);
+                if (cliffs && id != Terrain::Water &&
+                    slopeAt(j, i, width, height, islandScale, elevation[j], dx[j], dy[j]) > cliffSlope) {
+                    id = Terrain::Stone;
+                }
+                row[j].id = id;
+            }
+        }
+        addProgress(static_cast<long long>(end - begin) * width * (octaveTable.count + 2 * climate + 1));
+    });
+}
+
+void MapGenerator::adopt(const StageCache& cache, const MapParams& params) {
+    // The layers stay read-only while shared: ensureUnique copies on write.
+    // A cache without noise (biome, cliff or cancelled maps) has default
+    // noiseParams and no layers, so check for the full sum it claims.
+    const int cachedCount = std::clamp(cache.noiseParams.octaves, 0, OctaveTable::maxOctaves);
+    const bool hasNoise =
+        static_cast<int>(cache.octaveSums.size()) > cachedCount && cache.octaveSums[cachedCount];
+    if (hasNoise && cache.noiseParams.sameOctaveBasis(params)) {
+        for (auto& layer : octaveSums) retireLayer(layer);
+        octaveSums.clear();
+        for (const auto& layer : cache.octaveSums) {
+            octaveSums.push_back(std::const_pointer_cast<Grid2D<float>>(layer));
+        }
+        noiseParams = cache.noiseParams;
+        noiseValid = true;
+    }
+    if (cache.falloff && cache.falloffParams.sameFalloff(params)) {
+        falloffLayer = std::const_pointer_cast<Grid2D<float>>(cache.falloff);
+        falloffParams = cache.falloffParams;
+        falloffValid = true;
+    }
+}
+
+int MapGenerator::cachedOctaves(int count) const {
+    int k = std::min(count, static_cast<int>(octaveSums.size()) - 1);
+    while (k > 0 && !octaveSums[k]) --k;
+    return std::max(k, 0);
+}
+
+void MapGenerator::runStages(const MapParams& params) {
+    bool noiseStale = !noiseValid || !noiseParams.sameNoise(params);
+    const bool falloffStale = !falloffValid || !falloffParams.sameFalloff(params);
+    const bool heightStale = noiseStale || falloffStale || !heightValid;
+    // Without a cached full noise sum, classify-only maps use the early-out
+    // pass; biome and cliff maps always use the fused field pass
+    const bool fieldPass = params.biomes || params.cliffSlope > 0.0f;
+    const bool decided = params.classifyOnly && noiseStale && !fieldPass;
+    const bool fused = decided || fieldPass;
+    if (fused) noiseStale = false;
+
+    // Prefix sums built on other noise inputs are useless
+    if (!noiseValid || !noiseParams.sameOctaveBasis(params)) {
+        for (auto& layer : octaveSums) retireLayer(layer);
+        octaveSums.clear();
+        noiseValid = false;
+    }
+
+    width = params.width;
+    height = params.height;
+    islandScale = params.islandScale;
+    octaves = params.octaves;
+    persistence = params.persistence;
+    lacunarity = params.lacunarity;
+    baseScale = params.baseScale;
+    classifyOnly = params.classifyOnly;
+    biomes = params.biomes;
+    cliffSlope = params.cliffSlope;
+    if ((noiseStale || fused) &&
+        (params.seed != seed || params.noiseType != noiseType || params.fractal != fractal)) {
+        seed = params.seed;
+        noiseType = params.noiseType;
+        fractal = params.fractal;
+        noise = NoiseKernel(seed, noiseType, fractal);
+    }
+
+    // Work is counted in tiles, a noise tile costing one unit per computed octave
+    if (progress) {
+        const int count = OctaveTable(octaves, persistence, lacunarity).count;
+        const int climate = biomes ? 2 * std::min(count, climateOctaves) : 0;
+        long long passes = 1 + (noiseStale ? count - cachedOctaves(count) : 0) + (fused ? count + climate : 0) +
+                           (falloffStale ? 1 : 0) + (heightStale && !fused ? 1 : 0);
+        progress->workTotal = static_cast<long long>(width) * height * passes;
+    }
+
+    dirtyRect = DirtyRect{0, 0, width, height};
+    isDirty = true;
+    if (heightStale) heightValid = false;
+
+    // A stage interrupted by cancellation leaves its layer invalid and
+    // skips the rest of the pipeline
+    if (falloffStale) {
+        falloffValid = false;
+        generateFalloffMap();
+        if (isCancelled()) return;
+        falloffParams = params;
+        falloffValid = true;
+    }
+    if (fieldPass) {
+        heightValid = false;
+        generateFieldMap();
+        return;
+    }
+    if (decided) {
+        heightMap.resize(0, 0);
+        heightValid = false;
+        classifyDecided();
+        return;
+    }
+    if (noiseStale) {
+        // generateNoiseMap drops prefixes it could not finish, so after a
+        // cancellation the previous noiseParams still describe what is kept
+        generateNoiseMap();
+        if (isCancelled()) return;
+        noiseParams = params;
+        noiseValid = true;
+    }
+    if (heightStale) {
+        combineLayers();
+        if (isCancelled()) return;
+        heightValid = true;
+    }
+    // Classification always reruns: it is cheap and discards terrain edits
+    classifyTerrain();
+    if (classifyOnly) {
+        heightMap.resize(0, 0);
+        heightValid = false;
+    }
+}
+
+MapGenerator::MapGenerator(int w, int h, float scale, unsigned int seed, 
+                         int oct, float pers, float lac, float nScale,
+                         NoiseType noiseType)
+    : MapGenerator(MapParams{w, h, scale, seed, oct, pers, lac, nScale, noiseType}) {}
+
+MapGenerator::MapGenerator(const MapParams& params, GenerationProgress* progress, const StageCache* reuse)
+    : width(params.width), height(params.height), islandScale(params.islandScale),
+      noise(params.seed, params.noiseType, params.fractal), progress(progress),
+      dirtyRect{0, 0, params.width, params.height}, seed(params.seed), noiseType(params.noiseType),
+      fractal(params.fractal),
+      octaves(params.octaves), persistence(params.persistence), lacunarity(params.lacunarity),
+      baseScale(params.baseScale) {
+    if (reuse) adopt(*reuse, params);
+    runStages(params);
+    detachProgress();
+}
+
+void MapGenerator::regenerate(const MapParams& params, GenerationProgress* progress) {
+    this->progress = progress;
+    runStages(params);
+    detachProgress();
+}
+
+void MapGenerator::detachProgress() {
+    // The caller may free progress once generation returns, and copies of
+    // this map outlive it; keep only whether it was cancelled
+    cancelled = isCancelled();
+    progress = nullptr;
+}
+
+MapParams MapGenerator::getParams() const {
+    return MapParams{width, height, islandScale, seed, octaves, persistence, lacunarity, baseScale, noiseType,
+                     fractal, classifyOnly, biomes, cliffSlope};
+}
+
+StageCache MapGenerator::getStageCache() const {
+    StageCache cache;
+    if (noiseValid) {
+        cache.noiseParams = noiseParams;
+        cache.octaveSums.assign(octaveSums.begin(), octaveSums.end());
+    }
+    if (falloffValid) {
+        cache.falloffParams = falloffParams;
+        cache.falloff = falloffLayer;
+    }
+    return cache;
+}
+
+std::size_t MapGenerator::memoryBytes() const {
+    std::size_t bytes = grid.sizeBytes() + heightMap.sizeBytes();
+    for (const auto& layer : octaveSums) {
+        if (layer) bytes += layer->sizeBytes();
+    }
+    // Spares are kept for reuse, so they count like live layers
+    for (const auto& layer : spareLayers) bytes += layer->sizeBytes();
+    if (falloffLayer) bytes += falloffLayer->sizeBytes();
+    bytes += scratch.rows.sizeBytes();
+    return bytes;
+}
+
+// Writes one row of tiles as packed RGB
+static void colorizeRow(const TerrainTile* tiles, int width, unsigned char* out) {
+    for (int x = 0; x < width; ++x) {
+        const TerrainType& t = Terrain::type(tiles[x].id);
+        out[x * 3] = t.r;
+        out[x * 3 + 1] = t.g;
+        out[x * 3 + 2] = t.b;
+    }
+}
+
+void MapGenerator::setTerrain(int x, int y, TerrainId terrain) {
+    int invertedY = height - 1 - y;
+    if (x >= 0 && x < width && invertedY >= 0 && invertedY < height) {
+        TerrainTile& tile = grid(x, invertedY);
+        if (tile.id == terrain) return;
+        tile.id = terrain;
+        dirtyRect.add(x, invertedY);
+        isDirty = true;
+    }
+}
+
+void MapGenerator::invertTextures() {
+    for (int i = 0; i < height; ++i) {
+        TerrainTile* row = grid.row(i);
+        for (int j = 0; j < width; ++j) {
+            TerrainTile& tile = row[j];
+            switch (tile.getSymbol()) {
+                case 'W': tile.id = Terrain::Stone; break;
+                case 'S': tile.id = Terrain::Water; break;
+                case 'G': tile.id = Terrain::Beach; break;
+                case 'B': tile.id = Terrain::grass(5); break;
+                default: tile.id = Terrain::Water; break;
+            }
+        }
+    }
+    dirtyRect = DirtyRect{0, 0, width, height};
+    isDirty = true;
+}
+
+bool MapGenerator::exportToPNG(const std::string& filename) const {
+    // Colorize straight into vertically flipped rows
+    std::vector<unsigned char> flippedData(static_cast<size_t>(width) * height * 3);
+    const int rowSize = width * 3;
+    for(int y = 0; y < height; y++) {
+        const int srcY = height - 1 - y;
+        colorizeRow(grid.row(srcY), width, &flippedData[static_cast<size_t>(y) * rowSize]);
+    }
+
+    int result = stbi_write_png(filename.c_str(), width, height, 3, flippedData.data(), width * 3);
+    return result != 0;
+}
+
+bool MapGenerator::exportToPPM(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    file << "P3\n" << width << " " << height << "\n255\n";
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            const TerrainType& t = Terrain::type(grid(j, i).id);
+            file << static_cast<int>(t.r) << " "
+                 << static_cast<int>(t.g) << " "
+                 << static_cast<int>(t.b) << " ";
+        }
+        file << "\n";
+    }
+    file.close();
+    return true;
+}
\ No newline at end of file
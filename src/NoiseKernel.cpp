@@ -0,0 +1,746 @@
+#include "../headers/NoiseKernel.h"
+#include "../headers/Simd.h"
+#include "../perlin/PerlinNoise.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace simd;
+
+// Table of NoiseType::Baked, see bakeTile
+struct BakedTile {
+    // Lattice to tile coordinates of one octave: rotation scaled to tile
+    // samples, then an offset in samples
+    struct Transform {
+        float c, s, ox, oy;
+    };
+    // Per tile sample, the four corners of its bilinear cell in the order
+    // (x, y), (x + 1, y), (x, y + 1), (x + 1, y + 1), wrapping at the edges
+    std::vector<float> corners;
+    Transform octave[OctaveTable::maxOctaves];
+};
+
+namespace {
+
+// Same as SIVPERLIN_DEFAULT_Z; its lattice cell and fade weight are constant
+constexpr float defaultZ = 0.34567f;
+
+inline f32 fade(f32 t) {
+    return t * t * t * (t * (t * splatf(6.0f) - splatf(15.0f)) + splatf(10.0f));
+}
+
+// Derivative of fade
+inline f32 fadeSlope(f32 t) {
+    const f32 s = t * (splatf(1.0f) - t);
+    return s * s * splatf(30.0f);
+}
+
+inline f32 lerp(f32 a, f32 b, f32 t) {
+    return a + (b - a) * t;
+}
+
+// Vector form of siv::perlin_detail::Grad
+inline f32 grad(i32 hash, f32 x, f32 y, f32 z) {
+    const i32 h = hash & splati(15);
+    const f32 u = select(h < splati(8), x, y);
+    const f32 v = select(h < splati(4), y, select((h == splati(12)) | (h == splati(14)), x, z));
+    return flipSign(u, shiftLeft(h, 31)) + flipSign(v, shiftLeft(h & splati(2), 30));
+}
+
+// grad() with z = 0: the gradient set of the 3D lattice projected onto the plane
+inline f32 grad(i32 hash, f32 x, f32 y) {
+    const i32 h = hash & splati(15);
+    const f32 u = select(h < splati(8), x, y);
+    const f32 v = select(h < splati(4), y, select((h == splati(12)) | (h == splati(14)), x, splatf(0.0f)));
+    return flipSign(u, shiftLeft(h, 31)) + flipSign(v, shiftLeft(h & splati(2), 30));
+}
+
+// Gradient vector (gx, gy, gz) of grad(hash, x, y, z), whose value is
+// gx * x + gy * y + gz * z. Components are +-1 or 0, so that dot product is
+// exact and equals grad() bit for bit (up to the sign of a zero).
+inline void gradVector(i32 hash, f32& gx, f32& gy, f32& gz) {
+    const i32 h = hash & splati(15);
+    const i32 one = asInt(splatf(1.0f));
+    const i32 s0 = one ^ shiftLeft(h, 31);
+    const i32 s1 = one ^ shiftLeft(h & splati(2), 30);
+    const i32 uIsX = h < splati(8);
+    const i32 vIsY = h < splati(4);
+    const i32 vIsX = (h == splati(12)) | (h == splati(14));
+    const i32 all = splati(-1);
+    gx = asFloat((s0 & uIsX) | (s1 & vIsX));
+    gy = asFloat((s0 & (uIsX ^ all)) | (s1 & vIsY));
+    gz = asFloat(s1 & ((vIsY | vIsX) ^ all));
+}
+
+// The noise functions below also return the gradient of the noise with
+// respect to (x, y) through dx and dy when those are given. The corner dot
+// products then come from gradVector, which gives the same value.
+
+// siv::PerlinNoise::noise2D: a slice of the 3D lattice at z = defaultZ
+inline f32 perlinNoise(const std::int32_t* perm, f32 x, f32 y, f32* dx = nullptr, f32* dy = nullptr) {
+    const f32 x0 = floor(x);
+    const f32 y0 = floor(y);
+    const i32 ix = toInt(x0) & splati(255);
+    const i32 iy = toInt(y0) & splati(255);
+    const f32 fx = x - x0;
+    const f32 fy = y - y0;
+    const f32 fz = splatf(defaultZ);
+    const f32 one = splatf(1.0f);
+
+    const f32 u = fade(fx);
+    const f32 v = fade(fy);
+    const f32 w = fade(fz);
+
+    const i32 A = gather(perm, ix) + iy;
+    const i32 B = gather(perm, ix + splati(1)) + iy;
+    const i32 AA = gather(perm, A);
+    const i32 AB = gather(perm, A + splati(1));
+    const i32 BA = gather(perm, B);
+    const i32 BB = gather(perm, B + splati(1));
+
+    // Corners in x-fastest order, z = 0 then z = 1
+    const i32 h[8] = {gather(perm, AA), gather(perm, BA), gather(perm, AB), gather(perm, BB),
+                      gather(perm, AA + splati(1)), gather(perm, BA + splati(1)),
+                      gather(perm, AB + splati(1)), gather(perm, BB + splati(1))};
+    f32 p[8], gx[8], gy[8];
+    if (dx) {
+        for (int c = 0; c < 8; ++c) {
+            f32 gz;
+            gradVector(h[c], gx[c], gy[c], gz);
+            const f32 cx = c & 1 ? fx - one : fx;
+            const f32 cy = c & 2 ? fy - one : fy;
+            const f32 cz = c & 4 ? fz - one : fz;
+            p[c] = gx[c] * cx + gy[c] * cy + gz * cz;
+        }
+    } else {
+        p[0] = grad(h[0], fx, fy, fz);
+        p[1] = grad(h[1], fx - one, fy, fz);
+        p[2] = grad(h[2], fx, fy - one, fz);
+        p[3] = grad(h[3], fx - one, fy - one, fz);
+        p[4] = grad(h[4], fx, fy, fz - one);
+        p[5] = grad(h[5], fx - one, fy, fz - one);
+        p[6] = grad(h[6], fx, fy - one, fz - one);
+        p[7] = grad(h[7], fx - one, fy - one, fz - one);
+    }
+
+    const f32 q0 = lerp(p[0], p[1], u);
+    const f32 q1 = lerp(p[2], p[3], u);
+    const f32 q2 = lerp(p[4], p[5], u);
+    const f32 q3 = lerp(p[6], p[7], u);
+
+    if (dx) {
+        // Each corner's dot product changes by its gradient component; the
+        // fade weights add u' (and v') times the difference across the cell
+        const f32 du = fadeSlope(fx);
+        const f32 dv = fadeSlope(fy);
+        const f32 dx0 = lerp(lerp(gx[0], gx[1], u), lerp(gx[2], gx[3], u), v) + du * lerp(p[1] - p[0], p[3] - p[2], v);
+        const f32 dx1 = lerp(lerp(gx[4], gx[5], u), lerp(gx[6], gx[7], u), v) + du * lerp(p[5] - p[4], p[7] - p[6], v);
+        const f32 dy0 = lerp(lerp(gy[0], gy[1], u), lerp(gy[2], gy[3], u), v) + dv * (q1 - q0);
+        const f32 dy1 = lerp(lerp(gy[4], gy[5], u), lerp(gy[6], gy[7], u), v) + dv * (q3 - q2);
+        *dx = lerp(dx0, dx1, w);
+        *dy = lerp(dy0, dy1, w);
+    }
+    return lerp(lerp(q0, q1, v), lerp(q2, q3, v), w);
+}
+
+// Fade-weighted blend of the dot products at the four corners of a square
+// cell, with the gradients of grad(hash, x, y); (fx, fy) is the offset of the
+// sample from the cell origin
+inline f32 squareNoise(i32 h0, i32 h1, i32 h2, i32 h3, f32 fx, f32 fy, f32* dx, f32* dy) {
+    const f32 one = splatf(1.0f);
+    const f32 u = fade(fx);
+    const f32 v = fade(fy);
+
+    const i32 h[4] = {h0, h1, h2, h3};
+    f32 p[4], gx[4], gy[4];
+    if (dx) {
+        for (int c = 0; c < 4; ++c) {
+            f32 gz;
+            gradVector(h[c], gx[c], gy[c], gz);
+            p[c] = gx[c] * (c & 1 ? fx - one : fx) + gy[c] * (c & 2 ? fy - one : fy);
+        }
+    } else {
+        p[0] = grad(h0, fx, fy);
+        p[1] = grad(h1, fx - one, fy);
+        p[2] = grad(h2, fx, fy - one);
+        p[3] = grad(h3, fx - one, fy - one);
+    }
+
+    const f32 q0 = lerp(p[0], p[1], u);
+    const f32 q1 = lerp(p[2], p[3], u);
+    if (dx) {
+        *dx = lerp(lerp(gx[0], gx[1], u), lerp(gx[2], gx[3], u), v) + fadeSlope(fx) * lerp(p[1] - p[0], p[3] - p[2], v);
+        *dy = lerp(lerp(gy[0], gy[1], u), lerp(gy[2], gy[3], u), v) + fadeSlope(fy) * (q1 - q0);
+    }
+    return lerp(q0, q1, v);
+}
+
+// True 2D lattice on the same permutation: 4 gradients and 3 lerps per sample
+inline f32 perlinNoise2D(const std::int32_t* perm, f32 x, f32 y, f32* dx = nullptr, f32* dy = nullptr) {
+    const f32 x0 = floor(x);
+    const f32 y0 = floor(y);
+    const i32 ix = toInt(x0) & splati(255);
+    const i32 iy = toInt(y0) & splati(255);
+
+    const i32 A = gather(perm, ix) + iy;
+    const i32 B = gather(perm, ix + splati(1)) + iy;
+
+    return squareNoise(gather(perm, A), gather(perm, B), gather(perm, A + splati(1)), gather(perm, B + splati(1)),
+                       x - x0, y - y0, dx, dy);
+}
+
+// Mixes lattice coordinates and a seed into 32 well-distributed bits.
+// Lattice coordinates are not masked, so the pattern only repeats after
+// 2^32 cells, far beyond where float sample coordinates stay exact.
+inline i32 hashLattice(i32 ix, i32 iy, i32 seed) {
+    i32 h = seed ^ (ix * splati(static_cast<std::int32_t>(0x27d4eb2du))) ^
+            (iy * splati(static_cast<std::int32_t>(0x165667b1u)));
+    h = h ^ shiftRight(h, 15);
+    h = h * splati(static_cast<std::int32_t>(0x2c1b3c6du));
+    h = h ^ shiftRight(h, 12);
+    h = h * splati(static_cast<std::int32_t>(0x297a2d39u));
+    return h ^ shiftRight(h, 15);
+}
+
+// Gradient noise on the hashed lattice, with the gradients of perlinNoise2D.
+// The top hash bits select the gradient.
+inline f32 hashNoise(std::int32_t seed, f32 x, f32 y, f32* dx = nullptr, f32* dy = nullptr) {
+    const f32 x0 = floor(x);
+    const f32 y0 = floor(y);
+    const i32 ix = toInt(x0);
+    const i32 iy = toInt(y0);
+    const i32 s = splati(seed);
+    const i32 ix1 = ix + splati(1);
+    const i32 iy1 = iy + splati(1);
+
+    return squareNoise(shiftRight(hashLattice(ix, iy, s), 28), shiftRight(hashLattice(ix1, iy, s), 28),
+                       shiftRight(hashLattice(ix, iy1, s), 28), shiftRight(hashLattice(ix1, iy1, s), 28),
+                       x - x0, y - y0, dx, dy);
+}
+
+// OpenSimplex2 (2D, "fast" variant): three simplex corners per sample
+// instead of four square corners, radial falloff instead of fade lerps.
+// The lattice hash is hashLattice over the skewed cell coordinates and the
+// gradients are 32 evenly spaced unit vectors, scaled like the reference.
+constexpr float simplexSkew = 0.366025403784439f;
+constexpr float simplexUnskew = -0.21132486540518713f;
+constexpr float simplexRadiusSq = 0.5f;
+constexpr float simplexNormalize = 99.83685446303647f;
+
+struct SimplexGradients {
+    alignas(64) float x[32];
+    alignas(64) float y[32];
+
+    SimplexGradients() {
+        for (int i = 0; i < 32; ++i) {
+            const double angle = (i + 0.5) * 3.14159265358979323846 / 16.0;
+            x[i] = static_cast<float>(std::cos(angle) * simplexNormalize);
+            y[i] = static_cast<float>(std::sin(angle) * simplexNormalize);
+        }
+    }
+};
+
+const SimplexGradients simplexGradients;
+
+// Contribution a^4 * (g . d) of one corner, zero outside its radius.
+// With gradX, adds its gradient a^3 (a g - 8 (g . d) d), as da/dd = -2 d.
+inline f32 simplexCorner(i32 hash, f32 a, f32 dx, f32 dy, f32* gradX, f32* gradY) {
+    const i32 gi = shiftRight(hash, 27);
+    const f32 gx = gather(simplexGradients.x, gi);
+    const f32 gy = gather(simplexGradients.y, gi);
+    const f32 g = gx * dx + gy * dy;
+    const f32 a2 = max(a, splatf(0.0f)) * max(a, splatf(0.0f));
+    if (gradX) {
+        const f32 ap = max(a, splatf(0.0f));
+        const f32 a3 = a2 * ap;
+        const f32 g8 = g * splatf(8.0f);
+        *gradX = *gradX + a3 * (ap * gx - g8 * dx);
+        *gradY = *gradY + a3 * (ap * gy - g8 * dy);
+    }
+    return a2 * a2 * g;
+}
+
+inline f32 simplexNoise(std::int32_t seed, f32 x, f32 y, f32* gradX = nullptr, f32* gradY = nullptr) {
+    const f32 s = (x + y) * splatf(simplexSkew);
+    const f32 xs = x + s;
+    const f32 ys = y + s;
+    const f32 xsb = floor(xs);
+    const f32 ysb = floor(ys);
+    const i32 ix = toInt(xsb);
+    const i32 iy = toInt(ysb);
+    const f32 xi = xs - xsb;
+    const f32 yi = ys - ysb;
+    const i32 sd = splati(seed);
+    const i32 one = splati(1);
+
+    // Corner 0: the cell origin
+    const f32 t = (xi + yi) * splatf(simplexUnskew);
+    const f32 dx0 = xi + t;
+    const f32 dy0 = yi + t;
+    const f32 a0 = splatf(simplexRadiusSq) - dx0 * dx0 - dy0 * dy0;
+    if (gradX) *gradX = *gradY = splatf(0.0f);
+    f32 value = simplexCorner(hashLattice(ix, iy, sd), a0, dx0, dy0, gradX, gradY);
+
+    // Corner 1: the opposite corner (1, 1)
+    constexpr float u2 = 1.0f + 2.0f * simplexUnskew;
+    const f32 a1 = splatf(2.0f * u2 * (1.0f / simplexUnskew + 2.0f)) * t + (splatf(-2.0f * u2 * u2) + a0);
+    value = value + simplexCorner(hashLattice(ix + one, iy + one, sd), a1, dx0 - splatf(u2), dy0 - splatf(u2),
+                                  gradX, gradY);
+
+    // Corner 2: (0, 1) or (1, 0), whichever triangle the sample is in
+    const i32 upper = dx0 < dy0;
+    const f32 near = splatf(simplexUnskew);
+    const f32 far = splatf(simplexUnskew + 1.0f);
+    const f32 dx2 = dx0 - select(upper, near, far);
+    const f32 dy2 = dy0 - select(upper, far, near);
+    const f32 a2 = splatf(simplexRadiusSq) - dx2 * dx2 - dy2 * dy2;
+    const i32 ix2 = select(upper, ix, ix + one);
+    const i32 iy2 = select(upper, iy + one, iy);
+    return value + simplexCorner(hashLattice(ix2, iy2, sd), a2, dx2, dy2, gradX, gradY);
+}
+
+// Noise backends, selected at compile time by the row kernels below.
+// A backend is a small value type with
+//     static constexpr float bound;   // upper limit of |noise(x, y)|
+//     static constexpr float meanAbs, meanSquare;  // E|n| and E n^2
+//     f32 noise(f32 x, f32 y) const;  // simd::width samples at once
+//     f32 noise(f32 x, f32 y, f32& dx, f32& dy) const;  // and its gradient
+// so each row loop is instantiated per backend with no per-sample dispatch.
+//
+// Perlin-style bounds: a sample is a convex combination of corner dot
+// products, each at most the sum of the corner's |offset| per axis; per
+// axis the fade-weighted offsets sum to at most 0.5 (at t = 0.5), and for
+// the fixed z of the slice to 0.4162. The moments are measured over a few
+// seeds; the fractal policies use them to center their shapes.
+struct SliceLattice {
+    static constexpr float bound = 0.5f + 0.5f + 0.4162f;
+    static constexpr float meanAbs = 0.23f, meanSquare = 0.078f;
+    const std::int32_t* perm;
+    const SliceLattice& octave(int) const { return *this; }
+    f32 noise(f32 x, f32 y) const { return perlinNoise(perm, x, y); }
+    f32 noise(f32 x, f32 y, f32& dx, f32& dy) const { return perlinNoise(perm, x, y, &dx, &dy); }
+};
+
+struct PlaneLattice {
+    static constexpr float bound = 0.5f + 0.5f;
+    static constexpr float meanAbs = 0.205f, meanSquare = 0.064f;
+    const std::int32_t* perm;
+    const PlaneLattice& octave(int) const { return *this; }
+    f32 noise(f32 x, f32 y) const { return perlinNoise2D(perm, x, y); }
+    f32 noise(f32 x, f32 y, f32& dx, f32& dy) const { return perlinNoise2D(perm, x, y, &dx, &dy); }
+};
+
+struct HashLattice {
+    static constexpr float bound = 0.5f + 0.5f;
+    static constexpr float meanAbs = 0.205f, meanSquare = 0.064f;
+    std::int32_t seed;
+    const HashLattice& octave(int) const { return *this; }
+    f32 noise(f32 x, f32 y) const { return hashNoise(seed, x, y); }
+    f32 noise(f32 x, f32 y, f32& dx, f32& dy) const { return hashNoise(seed, x, y, &dx, &dy); }
+};
+
+// Bound: maximum over the cell of the sum of a^4 * |d| of the three corners
+// (0.010080, evaluated on a fine grid) times the gradient length, rounded up.
+struct SimplexLattice {
+    static constexpr float bound = 1.01f;
+    static constexpr float meanAbs = 0.47f, meanSquare = 0.295f;
+    std::int32_t seed;
+    const SimplexLattice& octave(int) const { return *this; }
+    f32 noise(f32 x, f32 y) const { return simplexNoise(seed, x, y); }
+    f32 noise(f32 x, f32 y, f32& dx, f32& dy) const { return simplexNoise(seed, x, y, &dx, &dy); }
+};
+
+// The tile repeats every bakedCells lattice cells with bakedRes samples per cell
+constexpr int bakedCells = 16;
+constexpr int bakedRes = 8;
+constexpr int bakedShift = 7;
+constexpr int bakedSize = 1 << bakedShift;
+static_assert(bakedSize == bakedCells * bakedRes, "tile side must be a power of two");
+
+// One octave's view of the baked tile: lattice coordinates are rotated,
+// scaled to tile samples and offset, then read bilinearly. No lattice
+// hashing or gradients per sample, only one four-corner gather from a
+// table that stays in cache.
+struct BakedOctave {
+    const float* corners;
+    BakedTile::Transform t;
+
+    f32 noise(f32 x, f32 y) const {
+        f32 dx, dy;
+        return sample<false>(x, y, dx, dy);
+    }
+    f32 noise(f32 x, f32 y, f32& dx, f32& dy) const { return sample<true>(x, y, dx, dy); }
+
+    template <bool Gradient>
+    f32 sample(f32 x, f32 y, f32& dx, f32& dy) const {
+        const f32 c = splatf(t.c);
+        const f32 s = splatf(t.s);
+        const f32 tx = x * c - y * s + splatf(t.ox);
+        const f32 ty = x * s + y * c + splatf(t.oy);
+        const f32 x0 = floor(tx);
+        const f32 y0 = floor(ty);
+        const i32 mask = splati(bakedSize - 1);
+        const i32 index = (toInt(x0) & mask) + shiftLeft(toInt(y0) & mask, bakedShift);
+        const f32 fx = tx - x0;
+        const f32 fy = ty - y0;
+
+        f32 a, b, d, e;
+        gather4(corners, index, a, b, d, e);
+        const f32 lower = lerp(a, b, fx);
+        const f32 upper = lerp(d, e, fx);
+        if (Gradient) {
+            // Bilinear gradient in tile samples, rotated back to lattice units
+            const f32 gx = lerp(b - a, e - d, fy);
+            const f32 gy = upper - lower;
+            dx = gx * c + gy * s;
+            dy = gy * c - gx * s;
+        }
+        return lerp(lower, upper, fy);
+    }
+};
+
+// Bound: bilinear blends of hash-lattice samples stay within the hash bound.
+// The interpolation smooths the moments slightly.
+struct BakedLattice {
+    static constexpr float bound = 0.5f + 0.5f;
+    static constexpr float meanAbs = 0.2f, meanSquare = 0.06f;
+    const BakedTile* tile;
+    BakedOctave octave(int o) const { return {tile->corners.data(), tile->octave[o]}; }
+};
+
+// Fractal policies: how each octave's noise n is shaped before it is
+// weighted and summed. Shapes are the same for every octave, so octave
+// prefix sums and the early-out bounds keep working. Each is built for a
+// backend with of<Lattice>(), which subtracts the shape's mean so the land
+// share stays near fBm's.
+//     f32 shape(f32 n) const;
+//     f32 slope(f32 n) const;      // d shape / dn
+//     float bound(float b) const;  // |shape(n)| for |n| <= b
+struct FBmFractal {
+    template <class Lattice>
+    static FBmFractal of() { return {}; }
+    f32 shape(f32 n) const { return n; }
+    f32 slope(f32) const { return splatf(1.0f); }
+    float bound(float b) const { return b; }
+};
+
+// Rounded bumps: |n| folds every valley into a crest
+struct BillowFractal {
+    float offset;  // E 2|n|
+
+    template <class Lattice>
+    static BillowFractal of() { return {2.0f * Lattice::meanAbs}; }
+    f32 shape(f32 n) const { return abs(n) * splatf(2.0f) - splatf(offset); }
+    f32 slope(f32 n) const { return flipSign(splatf(2.0f), asInt(n) & splati(INT32_MIN)); }
+    float bound(float b) const { return std::max(2.0f * b - offset, offset); }
+};
+
+// Sharp ridges along the zero lines of n
+struct RidgedFractal {
+    float offset;  // E 2 (1 - |n|)^2
+
+    template <class Lattice>
+    static RidgedFractal of() { return {2.0f * (1.0f - 2.0f * Lattice::meanAbs + Lattice::meanSquare)}; }
+    f32 shape(f32 n) const {
+        const f32 r = splatf(1.0f) - abs(n);
+        return r * r * splatf(2.0f) - splatf(offset);
+    }
+    f32 slope(f32 n) const {
+        const f32 r = splatf(1.0f) - abs(n);
+        return flipSign(r * splatf(-4.0f), asInt(n) & splati(INT32_MIN));
+    }
+    float bound(float b) const {
+        // (1 - |n|)^2 is at most max(1, (b - 1)^2)
+        return std::max(2.0f * std::max(1.0f, (b - 1.0f) * (b - 1.0f)) - offset, offset);
+    }
+};
+
+template <class Lattice, class Fractal>
+void fractalRowT(const Lattice& lattice, const Fractal& fractal, float* out, const float* in, int x0, int count, int y,
+                 float baseScale, const OctaveTable& octaves, int first, int last, int xStep) {
+    const float rowY = static_cast<float>(y) * baseScale;
+    const f32 scale = splatf(baseScale);
+    // Integer columns are exact in float, so strided rows match contiguous ones
+    const f32 laneX = toFloat(laneIndex()) * splatf(static_cast<float>(xStep));
+
+    for (int i = 0; i < count; i += width) {
+        const f32 colX = (splatf(static_cast<float>(x0 + i * xStep)) + laneX) * scale;
+        f32 sum = splatf(0.0f);
+        if (in) {
+            if (count - i >= width) sum = load(in + i);
+            else {
+                alignas(32) float tmp[width] = {};
+                std::memcpy(tmp, in + i, sizeof(float) * (count - i));
+                sum = load(tmp);
+            }
+        }
+        for (int o = first; o < last; ++o) {
+            const float freq = octaves.frequency[o];
+            const f32 n = fractal.shape(lattice.octave(o).noise(colX * splatf(freq), splatf(rowY * freq)));
+            sum = sum + n * splatf(octaves.amplitude[o]);
+        }
+        if (count - i >= width) store(out + i, sum);
+        else storePartial(out + i, sum, count - i);
+    }
+}
+
+// Lattice offsets that decorrelate the fields of fieldsRow. Large and
+// non-integer, so no field shares lattice cells or fade weights with another.
+constexpr float fieldOffset[NoiseKernel::maxFields][2] = {
+    {0.0f, 0.0f},
+    {71.37f, 19.81f},
+    {-43.13f, 117.59f},
+    {131.71f, -89.27f},
+};
+
+template <bool Gradient, class Lattice, class Fractal>
+void fieldsRowT(const Lattice& lattice, const Fractal& fractal, float* const* out, float* outDx, float* outDy,
+                const int* counts, int fieldCount, int x0, int count, int y, float baseScale,
+                const OctaveTable& octaves) {
+    int octaveCount = 0;
+    for (int f = 0; f < fieldCount; ++f) octaveCount = std::max(octaveCount, counts[f]);
+    const float rowY = static_cast<float>(y) * baseScale;
+    const f32 scale = splatf(baseScale);
+    const f32 laneX = toFloat(laneIndex());
+
+    for (int i = 0; i < count; i += width) {
+        // Same arithmetic as fractalRowT, so field 0 matches it bit for bit
+        const f32 colX = (splatf(static_cast<float>(x0 + i)) + laneX) * scale;
+        f32 sums[NoiseKernel::maxFields];
+        for (int f = 0; f < fieldCount; ++f) sums[f] = splatf(0.0f);
+        f32 gradX = splatf(0.0f);
+        f32 gradY = splatf(0.0f);
+        for (int o = 0; o < octaveCount; ++o) {
+            const float freq = octaves.frequency[o];
+            const f32 px = colX * splatf(freq);
+            const f32 py = splatf(rowY * freq);
+            const f32 amplitude = splatf(octaves.amplitude[o]);
+            if (o < counts[0]) {
+                if (Gradient) {
+                    // Chain rule through the shape and the octave's tile to
+                    // lattice scale
+                    f32 dx, dy;
+                    const f32 n = lattice.octave(o).noise(px, py, dx, dy);
+                    const f32 k = fractal.slope(n) * amplitude * splatf(freq * baseScale);
+                    gradX = gradX + dx * k;
+                    gradY = gradY + dy * k;
+                    sums[0] = sums[0] + fractal.shape(n) * amplitude;
+                } else {
+                    sums[0] = sums[0] + fractal.shape(lattice.octave(o).noise(px, py)) * amplitude;
+                }
+            }
+            for (int f = 1; f < fieldCount; ++f) {
+                if (o >= counts[f]) continue;
+                const f32 n = lattice.octave(o).noise(px + splatf(fieldOffset[f][0]), py + splatf(fieldOffset[f][1]));
+                sums[f] = sums[f] + n * amplitude;
+            }
+        }
+        for (int f = 0; f < fieldCount; ++f) {
+            if (count - i >= width) store(out[f] + i, sums[f]);
+            else storePartial(out[f] + i, sums[f], count - i);
+        }
+        if (Gradient) {
+            if (count - i >= width) {
+                store(outDx + i, gradX);
+                store(outDy + i, gradY);
+            } else {
+                storePartial(outDx + i, gradX, count - i);
+                storePartial(outDy + i, gradY, count - i);
+            }
+        }
+    }
+}
+
+template <class Lattice, class Fractal>
+void decidedRowT(const Lattice& lattice, const Fractal& fractal, float* out, int x0, int count, int y, float baseScale,
+                 const OctaveTable& octaves, const float* weight, const float* cuts, int cutCount) {
+    // Slack for float rounding in the sums and in the caller's classification
+    constexpr float slack = 1e-4f;
+    float remaining[OctaveTable::maxOctaves + 1];
+    remaining[octaves.count] = 0.0f;
+    for (int o = octaves.count - 1; o >= 0; --o) {
+        remaining[o] = remaining[o + 1] + std::fabs(octaves.amplitude[o]) * fractal.bound(Lattice::bound);
+    }
+
+    const float rowY = static_cast<float>(y) * baseScale;
+    const f32 scale = splatf(baseScale);
+    const f32 half = splatf(0.5f);
+    const f32 one = splatf(1.0f);
+
+    for (int i = 0; i < count; i += width) {
+        const f32 colX = toFloat(splati(x0 + i) + laneIndex()) * scale;
+        f32 w;
+        if (count - i >= width) w = load(weight + i);
+        else {
+            alignas(32) float tmp[width] = {};
+            std::memcpy(tmp, weight + i, sizeof(float) * (count - i));
+            w = load(tmp);
+        }
+
+        f32 sum = splatf(0.0f);
+        for (int o = 0; o < octaves.count; ++o) {
+            // Range the final (sum + 1) / 2 * weight can still reach
+            const f32 rem = splatf(remaining[o] + slack);
+            const f32 lo = (sum - rem + one) * half * w;
+            const f32 hi = (sum + rem + one) * half * w;
+            i32 decided = splati(-1);
+            for (int c = 0; c < cutCount; ++c) {
+                const f32 cut = splatf(cuts[c]);
+                decided = decided & ((hi < cut) | (cut < lo));
+            }
+            if (all(decided)) break;
+
+            const float freq = octaves.frequency[o];
+            const f32 n = fractal.shape(lattice.octave(o).noise(colX * splatf(freq), splatf(rowY * freq)));
+            sum = sum + n * splatf(octaves.amplitude[o]);
+        }
+        if (count - i >= width) store(out + i, sum);
+        else storePartial(out + i, sum, count - i);
+    }
+}
+
+// Bakes the tile of a seed: periodic hash-lattice noise (corner
+// coordinates wrapped to bakedCells) sampled on the tile grid
+std::shared_ptr<const BakedTile> bakeTile(std::uint32_t seed) {
+    std::vector<float> values(static_cast<std::size_t>(bakedSize) * bakedSize);
+    const i32 s = splati(static_cast<std::int32_t>(seed));
+    const i32 cellMask = splati(bakedCells - 1);
+    const f32 step = splatf(1.0f / bakedRes);
+    for (int j = 0; j < bakedSize; ++j) {
+        const f32 y = splatf(static_cast<float>(j) / bakedRes);
+        const f32 y0 = floor(y);
+        const i32 iy = toInt(y0);
+        const i32 iy0 = iy & cellMask;
+        const i32 iy1 = (iy + splati(1)) & cellMask;
+        for (int i = 0; i < bakedSize; i += width) {
+            const f32 x = toFloat(splati(i) + laneIndex()) * step;
+            const f32 x0 = floor(x);
+            const i32 ix = toInt(x0);
+            const i32 ix0 = ix & cellMask;
+            const i32 ix1 = (ix + splati(1)) & cellMask;
+            const f32 v = squareNoise(shiftRight(hashLattice(ix0, iy0, s), 28), shiftRight(hashLattice(ix1, iy0, s), 28),
+                                      shiftRight(hashLattice(ix0, iy1, s), 28), shiftRight(hashLattice(ix1, iy1, s), 28),
+                                      x - x0, y - y0, nullptr, nullptr);
+            store(values.data() + static_cast<std::size_t>(j) * bakedSize + i, v);
+        }
+    }
+
+    auto tile = std::make_shared<BakedTile>();
+    tile->corners.resize(values.size() * 4);
+    const int mask = bakedSize - 1;
+    for (int j = 0; j < bakedSize; ++j) {
+        for (int i = 0; i < bakedSize; ++i) {
+            float* out = tile->corners.data() + 4 * (static_cast<std::size_t>(j) * bakedSize + i);
+            out[0] = values[j * bakedSize + i];
+            out[1] = values[j * bakedSize + ((i + 1) & mask)];
+            out[2] = values[((j + 1) & mask) * bakedSize + i];
+            out[3] = values[((j + 1) & mask) * bakedSize + ((i + 1) & mask)];
+        }
+    }
+
+    // Octaves turn by the golden angle and shift along an R2 sequence, so
+    // no two read the tile in step
+    for (int o = 0; o < OctaveTable::maxOctaves; ++o) {
+        const double angle = o * 2.399963229728653;
+        const double shiftX = o * 0.7548776662466927;
+        const double shiftY = o * 0.5698402909980532;
+        tile->octave[o] = {static_cast<float>(std::cos(angle) * bakedRes),
+                           static_cast<float>(std::sin(angle) * bakedRes),
+                           static_cast<float>((shiftX - std::floor(shiftX)) * bakedSize),
+                           static_cast<float>((shiftY - std::floor(shiftY)) * bakedSize)};
+    }
+    return tile;
+}
+
+// The tile of a seed is baked once and shared while any kernel uses it
+std::shared_ptr<const BakedTile> bakedTile(std::uint32_t seed) {
+    static std::mutex mutex;
+    static std::unordered_map<std::uint32_t, std::weak_ptr<const BakedTile>> tiles;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::shared_ptr<const BakedTile> tile = tiles[seed].lock()) return tile;
+    // Seed searches go through many seeds: forget the expired ones
+    if (tiles.size() > 64) {
+        for (auto it = tiles.begin(); it != tiles.end();) {
+            if (it->second.expired()) it = tiles.erase(it);
+            else ++it;
+        }
+    }
+    std::shared_ptr<const BakedTile> tile = bakeTile(seed);
+    tiles[seed] = tile;
+    return tile;
+}
+
+}
+
+OctaveTable::OctaveTable(int octaves, float persistence, float lacunarity)
+    : count(std::clamp(octaves, 0, maxOctaves)) {
+    float amp = 1.0f;
+    float freq = 1.0f;
+    for (int o = 0; o < count; ++o) {
+        frequency[o] = freq;
+        amplitude[o] = amp;
+        amp *= persistence;
+        freq *= lacunarity;
+    }
+}
+
+NoiseKernel::NoiseKernel(std::uint32_t seed, NoiseType t, FractalType f)
+    : type(t), fractal(f), hashSeed(static_cast<std::int32_t>(seed)) {
+    const auto permutation = siv::PerlinNoise(seed).serialize();
+    for (int i = 0; i < 512; ++i) {
+        perm[i] = permutation[i & 255];
+    }
+    if (type == NoiseType::Baked) baked = bakedTile(seed);
+}
+
+template <class Fn>
+void NoiseKernel::dispatch(Fn&& fn) const {
+    // Backend and fractal are picked once per row; the per-sample loop has
+    // no dispatch
+    auto withFractal = [&](const auto& lattice) {
+        using Lattice = std::decay_t<decltype(lattice)>;
+        switch (fractal) {
+            case FractalType::Ridged: fn(lattice, RidgedFractal::of<Lattice>()); break;
+            case FractalType::Billow: fn(lattice, BillowFractal::of<Lattice>()); break;
+            default: fn(lattice, FBmFractal::of<Lattice>()); break;
+        }
+    };
+    switch (type) {
+        case NoiseType::Perlin2D: withFractal(PlaneLattice{perm}); break;
+        case NoiseType::Hash: withFractal(HashLattice{hashSeed}); break;
+        case NoiseType::OpenSimplex2: withFractal(SimplexLattice{hashSeed}); break;
+        case NoiseType::Baked: withFractal(BakedLattice{baked.get()}); break;
+        default: withFractal(SliceLattice{perm}); break;
+    }
+}
+
+void NoiseKernel::fractalRow(float* out, int x0, int count, int y, float baseScale, const OctaveTable& octaves) const {
+    octaveRow(out, nullptr, x0, count, y, baseScale, octaves, 0, octaves.count);
+}
+
+void NoiseKernel::octaveRow(float* out, const float* in, int x0, int count, int y, float baseScale,
+                            const OctaveTable& octaves, int first, int last, int xStep) const {
+    dispatch([&](const auto& lattice, auto shape) {
+        fractalRowT(lattice, shape, out, in, x0, count, y, baseScale, octaves, first, last, xStep);
+    });
+}
+
+void NoiseKernel::decidedRow(float* out, int x0, int count, int y, float baseScale, const OctaveTable& octaves,
+                             const float* weight, const float* cuts, int cutCount) const {
+    dispatch([&](const auto& lattice, auto shape) {
+        decidedRowT(lattice, shape, out, x0, count, y, baseScale, octaves, weight, cuts, cutCount);
+    });
+}
+
+void NoiseKernel::fieldsRow(float* const* out, const int* counts, int fieldCount, int x0, int count, int y,
+                            float baseScale, const OctaveTable& octaves, float* dx, float* dy) const {
+    fieldCount = std::clamp(fieldCount, 1, maxFields);
+    dispatch([&](const auto& lattice, auto shape) {
+        if (dx) fieldsRowT<true>(lattice, shape, out, dx, dy, counts, fieldCount, x0, count, y, baseScale, octaves);
+        else fieldsRowT<false>(lattice, shape, out, dx, dy, counts, fieldCount, x0, count, y, baseScale, octaves);
+    });
+}
@@ -0,0 +1,127 @@
+#include "../headers/SeedSearch.h"
+#include "../headers/MapGenerator.h"
+#include "../headers/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+// Seeds per parallelFor chunk; each chunk regenerates one map in place
+static const int seedGrain = 4;
+
+MapStats MapStats::of(const Grid2D<TerrainTile>& grid, float minIslandTiles) {
+    MapStats stats;
+    const int w = grid.width();
+    const int h = grid.height();
+    if (w == 0 || h == 0) return stats;
+
+    long long land = 0, stone = 0, coast = 0;
+    // Islands by flood fill over a visited mask
+    std::vector<unsigned char> seen(static_cast<std::size_t>(w) * h, 0);
+    std::vector<int> stack;
+    for (int y = 0; y < h; ++y) {
+        const TerrainTile* row = grid.row(y);
+        const TerrainTile* below = y + 1 < h ? grid.row(y + 1) : nullptr;
+        for (int x = 0; x < w; ++x) {
+            const bool isLand = row[x].id != Terrain::Water;
+            if (x + 1 < w && isLand != (row[x + 1].id != Terrain::Water)) ++coast;
+            if (below && isLand != (below[x].id != Terrain::Water)) ++coast;
+            if (!isLand) continue;
+            ++land;
+            if (row[x].id == Terrain::Stone) ++stone;
+            if (seen[y * w + x]) continue;
+
+            int area = 0;
+            seen[y * w + x] = 1;
+            stack.push_back(y * w + x);
+            while (!stack.empty()) {
+                const int at = stack.back();
+                stack.pop_back();
+                ++area;
+                const int cx = at % w;
+                const int cy = at / w;
+                const int next[4][2] = {{cx - 1, cy}, {cx + 1, cy}, {cx, cy - 1}, {cx, cy + 1}};
+                for (const auto& [nx, ny] : next) {
+                    if (nx < 0 || nx >= w || ny < 0 || ny >= h) continue;
+                    if (seen[ny * w + nx] || grid(nx, ny).id == Terrain::Water) continue;
+                    seen[ny * w + nx] = 1;
+                    stack.push_back(ny * w + nx);
+                }
+            }
+            if (area >= minIslandTiles) ++stats.islands;
+        }
+    }
+
+    const float tiles = static_cast<float>(w) * static_cast<float>(h);
+    stats.land = land / tiles;
+    stats.stone = stone / tiles;
+    stats.coastline = static_cast<float>(coast);
+    return stats;
+}
+
+float StatRange::penalty(float value) const {
+    const bool hasMin = std::isfinite(min);
+    const bool hasMax = std::isfinite(max);
+    if (hasMin && hasMax) {
+        const float half = std::max((max - min) / 2.0f, 1e-6f);
+        return std::fabs(value - (min + max) / 2.0f) / half;
+    }
+    // One-sided: relative distance past the bound
+    if (hasMin && value < min) return 1.0f + (min - value) / std::max(std::fabs(min), 1e-6f);
+    if (hasMax && value > max) return 1.0f + (value - max) / std::max(std::fabs(max), 1e-6f);
+    return 0.0f;
+}
+
+float SeedCriteria::score(const MapStats& stats) const {
+    return land.penalty(stats.land) + stone.penalty(stats.stone) +
+           islands.penalty(static_cast<float>(stats.islands)) + coastline.penalty(stats.coastline);
+}
+
+MapParams downscaledParams(const MapParams& params, int longSide) {
+    MapParams scaled = params;
+    scaled.classifyOnly = true;
+    const int side = std::max(params.width, params.height);
+    if (longSide <= 0 || side <= longSide) return scaled;
+
+    const float factor = static_cast<float>(side) / static_cast<float>(longSide);
+    scaled.width = std::max(1, static_cast<int>(std::lround(params.width / factor)));
+    scaled.height = std::max(1, static_cast<int>(std::lround(params.height / factor)));
+    scaled.baseScale = params.baseScale * factor;
+    scaled.cliffSlope = params.cliffSlope * factor;
+    // Octaves whose period shrinks below a tile only alias
+    if (params.lacunarity > 1.0f) {
+        const int finer = static_cast<int>(std::floor(std::log(factor) / std::log(params.lacunarity)));
+        scaled.octaves = std::max(1, params.octaves - finer);
+    }
+    return scaled;
+}
+
+std::vector<SeedResult> searchSeeds(const MapParams& params, const SeedCriteria& criteria, unsigned int firstSeed,
+                                    int count, int top, int longSide) {
+    MapParams scaled = downscaledParams(params, longSide);
+    const float lengthScale = static_cast<float>(params.width) / static_cast<float>(scaled.width);
+
+    std::vector<SeedResult> results(std::max(count, 0));
+    ThreadPool::shared().parallelFor(count, seedGrain, [&](int begin, int end) {
+        // Falloff carries over between the seeds of a chunk; generation
+        // inside runs inline on this thread
+        MapParams seedParams = scaled;
+        seedParams.seed = firstSeed + begin;
+        MapGenerator map(seedParams);
+        for (int i = begin; i < end; ++i) {
+            if (i > begin) {
+                seedParams.seed = firstSeed + i;
+                map.regenerate(seedParams);
+            }
+            MapStats stats = MapStats::of(map.getGrid(), criteria.minIslandTiles / (lengthScale * lengthScale));
+            stats.coastline *= lengthScale;
+            results[i] = {seedParams.seed, criteria.score(stats), stats};
+        }
+    });
+
+    const std::size_t kept = std::min(results.size(), static_cast<std::size_t>(std::max(top, 0)));
+    std::partial_sort(results.begin(), results.begin() + kept, results.end(),
+                      [](const SeedResult& a, const SeedResult& b) {
+                          return a.score != b.score ? a.score < b.score : a.seed < b.seed;
+                      });
+    results.resize(kept);
+    return results;
+}
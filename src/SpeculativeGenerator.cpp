@@ -0,0 +1,106 @@
+#include "../headers/SpeculativeGenerator.h"
+#include "../headers/ThreadPool.h"
+#include <algorithm>
+
+SpeculativeGenerator::SpeculativeGenerator() {
+    worker = std::thread(&SpeculativeGenerator::workerLoop, this);
+}
+
+SpeculativeGenerator::~SpeculativeGenerator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        if (active) active->cancelled = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+std::vector<MapParams> SpeculativeGenerator::neighbours(const MapParams& params) {
+    // The editor's seed field steps by one and its octave slider by one notch
+    std::vector<MapParams> next(2, params);
+    next[0].seed = params.seed + 1;
+    next[1].seed = params.seed - 1;
+    if (params.octaves < maxOctaves) {
+        next.push_back(params);
+        next.back().octaves = params.octaves + 1;
+    }
+    if (params.octaves > minOctaves) {
+        next.push_back(params);
+        next.back().octaves = params.octaves - 1;
+    }
+    return next;
+}
+
+void SpeculativeGenerator::speculate(const MapParams& params, StageCache stages) {
+    const std::vector<MapParams> next = neighbours(params);
+    auto wanted = [&](const MapParams& p) { return std::find(next.begin(), next.end(), p) != next.end(); };
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        hasCenter = true;
+        center = params;
+        centerStages = std::move(stages);
+        ready.erase(std::remove_if(ready.begin(), ready.end(), [&](const auto& r) { return !wanted(r.first); }),
+                    ready.end());
+        queue.clear();
+        for (const MapParams& p : next) {
+            const bool isReady = std::any_of(ready.begin(), ready.end(), [&](const auto& r) { return r.first == p; });
+            const bool isActive = active && !active->cancelled && activeParams == p;
+            if (!isReady && !isActive) queue.push_back(p);
+        }
+        if (active && !wanted(activeParams)) active->cancelled = true;
+    }
+    wake.notify_all();
+}
+
+bool SpeculativeGenerator::isAround(const MapParams& params) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hasCenter && center == params;
+}
+
+void SpeculativeGenerator::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    hasCenter = false;
+    centerStages = StageCache();
+    queue.clear();
+    if (active) active->cancelled = true;
+}
+
+std::unique_ptr<MapGenerator> SpeculativeGenerator::take(const MapParams& params) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = std::find_if(ready.begin(), ready.end(), [&](const auto& r) { return r.first == params; });
+    if (found == ready.end()) return nullptr;
+    std::unique_ptr<MapGenerator> map = std::move(found->second);
+    ready.erase(found);
+    return map;
+}
+
+void SpeculativeGenerator::workerLoop() {
+    for (;;) {
+        MapParams params;
+        StageCache stages;
+        std::shared_ptr<GenerationProgress> progress;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (stopping) return;
+            params = queue.front();
+            queue.erase(queue.begin());
+            stages = centerStages;
+            progress = std::make_shared<GenerationProgress>();
+            active = progress;
+            activeParams = params;
+        }
+
+        std::unique_ptr<MapGenerator> map;
+        {
+            // One core at most, and never the pool's workers
+            ThreadPool::SerialScope serial;
+            map = std::make_unique<MapGenerator>(params, progress.get(), &stages);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!progress->cancelled) ready.emplace_back(params, std::move(map));
+        active.reset();
+    }
+}
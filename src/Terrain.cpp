@@ -0,0 +1,49 @@
+#include "../headers/Terrain.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+std::array<TerrainType, Terrain::typeCount> buildTypeTable() {
+    std::array<TerrainType, Terrain::typeCount> table{};
+    table[Terrain::Water] = {'W', 0, 0, 255};
+    table[Terrain::Beach] = {'B', 245, 222, 179};
+    table[Terrain::Stone] = {'S', 128, 128, 128};
+    for (int v = 0; v <= Terrain::maxGrassValue; ++v) {
+        table[Terrain::GrassBase + v] = {'G', 0, static_cast<unsigned char>(v * 25), 0};
+    }
+    table[Terrain::Snow] = {'N', 240, 240, 250};
+    table[Terrain::Tundra] = {'T', 150, 160, 130};
+    table[Terrain::Taiga] = {'A', 40, 90, 70};
+    table[Terrain::Forest] = {'F', 20, 110, 30};
+    table[Terrain::Jungle] = {'J', 0, 80, 20};
+    table[Terrain::Savanna] = {'V', 180, 170, 80};
+    table[Terrain::Desert] = {'D', 230, 200, 120};
+    return table;
+}
+
+const std::array<TerrainType, Terrain::typeCount> typeTable = buildTypeTable();
+
+}
+
+TerrainId Terrain::grass(int value) {
+    return static_cast<TerrainId>(GrassBase + std::clamp(value, 0, maxGrassValue));
+}
+
+const TerrainType& Terrain::type(TerrainId id) {
+    return typeTable[id < typeCount ? id : Water];
+}
+
+void Terrain::getColor(TerrainId id, unsigned char& r, unsigned char& g, unsigned char& b) {
+    const TerrainType& t = type(id);
+    r = t.r; g = t.g; b = t.b;
+}
+
+void Terrain::generatePalette(std::vector<unsigned char>& data) {
+    data.assign(256 * 3, 0);
+    for (int id = 0; id < typeCount; ++id) {
+        data[id * 3] = typeTable[id].r;
+        data[id * 3 + 1] = typeTable[id].g;
+        data[id * 3 + 2] = typeTable[id].b;
+    }
+}
@@ -0,0 +1,98 @@
+#include "../headers/ThreadPool.h"
+
+namespace {
+thread_local bool insideTask = false;
+std::unique_ptr<ThreadPool> sharedPool;
+std::mutex sharedPoolMutex;
+}
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::work(Job& job) {
+    bool wasInside = insideTask;
+    insideTask = true;
+    for (;;) {
+        int begin = job.nextChunk.fetch_add(1, std::memory_order_relaxed) * job.grain;
+        if (begin >= job.count) break;
+        job.invoke(job.fn, begin, std::min(begin + job.grain, job.count));
+    }
+    insideTask = wasInside;
+}
+
+void ThreadPool::run(Job& job) {
+    std::unique_lock<std::mutex> submit(submitMutex, std::defer_lock);
+    if (workers.empty() || insideTask || job.count <= job.grain || !submit.try_lock()) {
+        work(job);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = &job;
+        ++generation;
+    }
+    wake.notify_all();
+    work(job);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return job.active == 0; });
+    current = nullptr;
+}
+
+void ThreadPool::workerLoop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        Job* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            job = current;
+            if (!job) continue;
+            ++job->active;
+        }
+        work(*job);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--job->active == 0) done.notify_all();
+        }
+    }
+}
+
+ThreadPool::SerialScope::SerialScope() : saved(insideTask) {
+    insideTask = true;
+}
+
+ThreadPool::SerialScope::~SerialScope() {
+    insideTask = saved;
+}
+
+ThreadPool& ThreadPool::shared() {
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    if (!sharedPool) sharedPool = std::make_unique<ThreadPool>();
+    return *sharedPool;
+}
+
+void ThreadPool::setSharedThreadCount(int threadCount) {
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    sharedPool = std::make_unique<ThreadPool>(threadCount);
+}
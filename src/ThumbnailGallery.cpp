@@ -0,0 +1,104 @@
+#include "../headers/ThumbnailGallery.h"
+#include "../headers/SeedSearch.h"
+#include "../headers/ThreadPool.h"
+#include <algorithm>
+
+ThumbnailGallery::ThumbnailGallery(int size, int capacity)
+    : size(std::max(size, 1)), capacity(std::max(capacity, 1)) {
+    worker = std::thread(&ThumbnailGallery::workerLoop, this);
+}
+
+ThumbnailGallery::~ThumbnailGallery() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void ThumbnailGallery::request(const MapParams& params, const std::vector<unsigned int>& seeds) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wanted.clear();
+        nextWanted = 0;
+        MapParams key = downscaledParams(params, size);
+        for (unsigned int seed : seeds) {
+            key.seed = seed;
+            if (index.find(key) == index.end()) wanted.push_back(key);
+        }
+    }
+    wake.notify_all();
+}
+
+ThumbnailGallery::Thumbnail ThumbnailGallery::find(const MapParams& params) {
+    const MapParams key = downscaledParams(params, size);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found == index.end()) return nullptr;
+    entries.splice(entries.begin(), entries, found->second);
+    return found->second->tiles;
+}
+
+void ThumbnailGallery::setPaused(bool pause) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        paused = pause;
+    }
+    wake.notify_all();
+}
+
+bool ThumbnailGallery::isBusy() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return generating || nextWanted < wanted.size();
+}
+
+void ThumbnailGallery::insert(const MapParams& key, Thumbnail tiles) {
+    auto found = index.find(key);
+    if (found != index.end()) {
+        entries.erase(found->second);
+        index.erase(found);
+    }
+    entries.push_front({key, std::move(tiles)});
+    index[key] = entries.begin();
+    while (static_cast<int>(entries.size()) > capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+void ThumbnailGallery::workerLoop() {
+    // A batch fills the pool once or twice, short enough that a changed
+    // request or a pause takes effect quickly
+    const int batchSize = 2 * ThreadPool::shared().size();
+    std::vector<MapParams> batch;
+    std::vector<Thumbnail> made;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            generating = false;
+            wake.wait(lock, [&] { return stopping || (!paused && nextWanted < wanted.size()); });
+            if (stopping) return;
+            batch.clear();
+            while (nextWanted < wanted.size() && static_cast<int>(batch.size()) < batchSize) {
+                const MapParams& key = wanted[nextWanted++];
+                if (index.find(key) == index.end()) batch.push_back(key);
+            }
+            generating = true;
+        }
+
+        made.assign(batch.size(), nullptr);
+        // One thumbnail per task; generation inside runs inline
+        ThreadPool::shared().parallelFor(static_cast<int>(batch.size()), 1, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                MapGenerator map(batch[i]);
+                made[i] = std::make_shared<const Grid2D<TerrainTile>>(map.getGrid());
+            }
+        });
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            insert(batch[i], std::move(made[i]));
+        }
+    }
+}
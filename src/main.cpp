@@ -1,5 +1,7 @@
-#define NOMINMAX  
+#ifdef _WIN32
+#define NOMINMAX
 #include <windows.h>
+#endif
 #include <algorithm>  
 #include <cstring>
 
@@ -8,8 +10,15 @@
 #include <memory>
 #include <cstdlib>
 #include <ctime>
+#include <limits>
+#include <random>
+#include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include "../headers/MapGenerator.h"
+#include "../headers/AsyncGenerator.h"
+#include "../headers/MapCache.h"
+#include "../headers/SpeculativeGenerator.h"
+#include "../headers/ThumbnailGallery.h"
 #include "../headers/TextureManager.h"
 #include "../headers/MapMarker.h"
 #include "../imgui/imgui.h"
@@ -22,7 +31,9 @@ int mapHeight = 300;
 
 // Global variables
 MapGenerator* map = nullptr;
-GLuint textureID;
+GLuint textureID;         // R8 terrain ids, one texel per tile
+GLuint paletteTextureID;  // 256x1 RGB colors indexed by terrain id
+GLuint terrainProgram;
 char currentTerrainType = 'W';
 int brushRadius = 3;
 bool isMousePressed = false;
@@ -34,6 +45,89 @@ bool removalMode = false;
 char exportFileName[256] = "";
 bool exportSuccess = false;
 
+// Looks up each tile's color from its id in the palette texture
+const char* terrainVertexShader = R"(
+#version 120
+void main() {
+    gl_TexCoord[0] = gl_MultiTexCoord0;
+    gl_Position = gl_Vertex;
+}
+)";
+
+const char* terrainFragmentShader = R"(
+#version 120
+uniform sampler2D indexTexture;
+uniform sampler2D paletteTexture;
+void main() {
+    float id = texture2D(indexTexture, gl_TexCoord[0].st).r * 255.0;
+    gl_FragColor = texture2D(paletteTexture, vec2((id + 0.5) / 256.0, 0.5));
+}
+)";
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Shader compile failed: " << log << std::endl;
+    }
+    return shader;
+}
+
+GLuint createTerrainProgram() {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, terrainVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, terrainFragmentShader);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "indexTexture"), 0);
+    glUniform1i(glGetUniformLocation(program, "paletteTexture"), 1);
+    glUseProgram(0);
+    return program;
+}
+
+void uploadPalette() {
+    std::vector<unsigned char> palette;
+    Terrain::generatePalette(palette);
+    glBindTexture(GL_TEXTURE_2D, paletteTextureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, 256, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, palette.data());
+}
+
+// Uploads the terrain ids of rect straight from the map grid
+void uploadTerrainIds(const Grid2D<TerrainTile>& grid, const DirtyRect& rect) {
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(grid.stride()));
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x0, rect.y0, rect.width(), rect.height(),
+                   GL_RED, GL_UNSIGNED_BYTE, &grid(rect.x0, rect.y0));
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+// Uploads a gallery thumbnail as RGB, for drawing with ImGui::Image
+void uploadThumbnail(GLuint texture, const Grid2D<TerrainTile>& tiles) {
+    std::vector<unsigned char> rgb(static_cast<std::size_t>(tiles.width()) * tiles.height() * 3);
+    for (int y = 0; y < tiles.height(); ++y) {
+        const TerrainTile* row = tiles.row(y);
+        unsigned char* out = rgb.data() + static_cast<std::size_t>(y) * tiles.width() * 3;
+        for (int x = 0; x < tiles.width(); ++x) {
+            const TerrainType& t = Terrain::type(row[x].id);
+            out[x * 3] = t.r;
+            out[x * 3 + 1] = t.g;
+            out[x * 3 + 2] = t.b;
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, tiles.width(), tiles.height(), 0, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+}
+
 // Function to edit a circle of tiles around the cursor
 void editCircle(int centerX, int centerY) {
     for (int i = -brushRadius; i <= brushRadius; ++i) {
@@ -43,10 +137,10 @@ void editCircle(int centerX, int centerY) {
                 int tileY = centerY + j;  // Now using correct Y-axis orientation
                 
                 switch (currentTerrainType) {
-                    case 'W': map->setTerrain(tileX, tileY, std::make_unique<Water>()); break;
-                    case 'G': map->setTerrain(tileX, tileY, std::make_unique<Grass>(5)); break;
-                    case 'S': map->setTerrain(tileX, tileY, std::make_unique<Stone>()); break;
-                    case 'B': map->setTerrain(tileX, tileY, std::make_unique<Beach>()); break;
+                    case 'W': map->setTerrain(tileX, tileY, Terrain::Water); break;
+                    case 'G': map->setTerrain(tileX, tileY, Terrain::grass(5)); break;
+                    case 'S': map->setTerrain(tileX, tileY, Terrain::Stone); break;
+                    case 'B': map->setTerrain(tileX, tileY, Terrain::Beach); break;
                     default: std::cerr << "Unknown terrain type!" << std::endl;
                 }
             }
@@ -151,13 +245,24 @@ int main() {
     if (!glfwInit()) return -1;
     GLFWwindow* window = glfwCreateWindow(900, 900, "Optimized Terrain Map", nullptr, nullptr);
     glfwMakeContextCurrent(window);  
+    if (glewInit() != GLEW_OK) {
+        std::cerr << "Failed to initialize GLEW" << std::endl;
+        return -1;
+    }
     textureManager.generateDefaultTextures();  
 
-    // Initialize texture
+    // Initialize index and palette textures
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_2D, textureID);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glGenTextures(1, &paletteTextureID);
+    glBindTexture(GL_TEXTURE_2D, paletteTextureID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    terrainProgram = createTerrainProgram();
 
     // Initialize ImGui
     IMGUI_CHECKVERSION();
@@ -174,15 +279,81 @@ int main() {
     float persistence = 0.5f;
     float lacunarity = 2.0f;
     float noiseScale = 0.03f;
+    int noiseType = static_cast<int>(NoiseType::Perlin);
+    int fractal = static_cast<int>(FractalType::FBm);
+    bool biomes = false;
+    float cliffSlope = 0.0f;
+
+    auto currentParams = [&]() {
+        MapParams params;
+        params.width = mapWidth;
+        params.height = mapHeight;
+        params.islandScale = islandScale;
+        params.seed = static_cast<unsigned int>(seed);
+        params.octaves = octaves;
+        params.persistence = persistence;
+        params.lacunarity = lacunarity;
+        params.baseScale = noiseScale;
+        params.noiseType = static_cast<NoiseType>(noiseType);
+        params.fractal = static_cast<FractalType>(fractal);
+        params.biomes = biomes;
+        params.cliffSlope = cliffSlope;
+        return params;
+    };
+
+    map = new MapGenerator(currentParams());
+    // Maps seen before are restored from here instead of regenerated
+    MapCache mapCache;
+    mapCache.put(*map);
+
+    // Regenerated maps are built in the background; the old one stays on screen
+    AsyncGenerator generator;
+    // While idle, the likely next maps are built ahead
+    SpeculativeGenerator speculator;
+
+    // Real requests stop speculation first and swap in a cached or
+    // speculated map when one matches
+    auto requestMap = [&](const MapParams& params) {
+        speculator.cancel();
+        std::unique_ptr<MapGenerator> ready = mapCache.find(params);
+        if (!ready && (ready = speculator.take(params))) mapCache.put(*ready);
+        if (ready) {
+            generator.cancel();
+            delete map;
+            map = ready.release();
+            return;
+        }
+        generator.request(params, map->getStageCache());
+    };
+
+    // Seed gallery: a page of thumbnails made in the background, the next
+    // page ahead of paging; clicking one generates that seed in full
+    ThumbnailGallery gallery;
+    const int galleryColumns = 4;
+    const int galleryPage = galleryColumns * 3;
+    bool showGallery = false;
+    int galleryFirst = seed;
+    // "Random" pages differ from session to session
+    std::mt19937 galleryRandom{std::random_device{}()};
+    std::uniform_int_distribution<int> randomFirst(0, std::numeric_limits<int>::max() - 2 * galleryPage);
+    MapParams galleryParams;
+    int galleryRequested = galleryFirst - 1;
+    std::vector<GLuint> thumbnailTextures(galleryPage);
+    std::vector<ThumbnailGallery::Thumbnail> shownThumbnails(galleryPage);
+    glGenTextures(galleryPage, thumbnailTextures.data());
+    for (GLuint texture : thumbnailTextures) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
 
-    map = new MapGenerator(mapWidth, mapHeight, islandScale, seed, 
-                          octaves, persistence, lacunarity, noiseScale);
-
-    // Initial texture upload
-    std::vector<unsigned char> textureData;
-    map->generateTextureData(textureData);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, mapWidth, mapHeight, 0, 
-                GL_RGB, GL_UNSIGNED_BYTE, textureData.data());
+    // Initial texture upload (one byte per texel, rows not padded to 4 bytes)
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    uploadPalette();
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, mapWidth, mapHeight, 0,
+                GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    uploadTerrainIds(map->getGrid(), DirtyRect{0, 0, mapWidth, mapHeight});
     map->markClean();
 
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
@@ -194,12 +365,31 @@ int main() {
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
 
-        // Update texture if needed
+        // Show coarse levels of a running generation as they arrive
+        if (std::unique_ptr<Grid2D<TerrainTile>> preview = generator.takePreview()) {
+            if (preview->width() == mapWidth && preview->height() == mapHeight) {
+                uploadTerrainIds(*preview, DirtyRect{0, 0, mapWidth, mapHeight});
+            }
+        }
+
+        // Swap in a finished map
+        if (std::unique_ptr<MapGenerator> ready = generator.takeResult()) {
+            mapCache.put(*ready);
+            delete map;
+            map = ready.release();
+        }
+
+        // Idle: build the likely next maps around the one on screen
+        if (!generator.isBusy() && !speculator.isAround(map->getParams())) {
+            speculator.speculate(map->getParams(), map->getStageCache());
+        }
+
+        // Update only the part of the texture that changed
         if (map->getIsDirty()) {
-            map->generateTextureData(textureData);
-            glBindTexture(GL_TEXTURE_2D, textureID);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mapWidth, mapHeight,
-                           GL_RGB, GL_UNSIGNED_BYTE, textureData.data());
+            const DirtyRect& dirty = map->getDirtyRect();
+            if (!dirty.empty()) {
+                uploadTerrainIds(map->getGrid(), dirty);
+            }
             map->markClean();
         }
 
@@ -210,15 +400,40 @@ int main() {
 
         // Terrain Controls Window
         ImGui::Begin("Terrain Controls");
-        ImGui::SliderFloat("Island Scale", &islandScale, 0.5f, 2.0f);
+        bool islandChanged = ImGui::SliderFloat("Island Scale", &islandScale, 0.5f, 2.0f);
         ImGui::InputInt("Seed", &seed);
-        ImGui::SliderInt("Octaves", &octaves, 1, 16);
-
-        if (ImGui::Button("Regenerate")) {
-            delete map;
-            map = new MapGenerator(mapWidth, mapHeight, islandScale, seed, 
-                                 octaves, persistence, lacunarity, noiseScale);
+        ImGui::SliderInt("Octaves", &octaves, SpeculativeGenerator::minOctaves, SpeculativeGenerator::maxOctaves);
+        ImGui::Combo("Noise", &noiseType, "Perlin\0Perlin 2D (fast)\0Hash (no repeat)\0OpenSimplex2\0Baked (fast preview)\0");
+        ImGui::Combo("Fractal", &fractal, "fBm\0Ridged\0Billow\0");
+        ImGui::Checkbox("Biomes", &biomes);
+        ImGui::SliderFloat("Cliff Slope", &cliffSlope, 0.0f, 0.1f, cliffSlope > 0.0f ? "%.3f" : "off");
+
+        MapParams params = currentParams();
+        // Island scale only reruns the falloff and later stages, cheap
+        // enough to follow the slider live (biome and cliff maps rerun their
+        // fused noise pass, so they wait for Regenerate)
+        const bool fieldPass = params.biomes || params.cliffSlope > 0.0f;
+        const bool liveIsland = islandChanged && !fieldPass && params.sameNoise(map->getParams());
+        if (ImGui::Button("Regenerate") || liveIsland) {
+            requestMap(params);
         }
+        if (generator.isBusy()) {
+            // Parameters changed again: restart with the new ones
+            if (generator.getRequested() != params) {
+                requestMap(params);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Cancel")) {
+                generator.cancel();
+                // Replace any preview with the map that stays
+                uploadTerrainIds(map->getGrid(), DirtyRect{0, 0, mapWidth, mapHeight});
+            }
+            ImGui::ProgressBar(generator.getProgress());
+        }
+        const MapCache::Stats& cacheStats = mapCache.getStats();
+        ImGui::Text("Map cache: %d maps, %.1f MB, %lld hits, %lld misses", mapCache.size(),
+                    mapCache.memoryBytes() / (1024.0 * 1024.0), cacheStats.hits, cacheStats.misses);
+        ImGui::Checkbox("Seed Gallery", &showGallery);
         ImGui::Separator();
         ImGui::Text("Export Settings:");
         ImGui::InputText("File Name", exportFileName, IM_ARRAYSIZE(exportFileName));
@@ -260,6 +475,59 @@ int main() {
         ImGui::RadioButton("Beach", (int*)&currentTerrainType, 'B');
         ImGui::End();
 
+        if (showGallery) {
+            ImGui::Begin("Seed Gallery", &showGallery);
+            if (ImGui::Button("< Prev")) galleryFirst -= galleryPage;
+            ImGui::SameLine();
+            if (ImGui::Button("Next >")) galleryFirst += galleryPage;
+            ImGui::SameLine();
+            if (ImGui::Button("From Seed")) galleryFirst = seed;
+            ImGui::SameLine();
+            if (ImGui::Button("Random")) galleryFirst = randomFirst(galleryRandom);
+
+            // Thumbnails follow the current settings, whatever their seed
+            MapParams thumbParams = currentParams();
+            thumbParams.seed = 0;
+            if (thumbParams != galleryParams || galleryFirst != galleryRequested) {
+                std::vector<unsigned int> seeds(2 * galleryPage);
+                for (int i = 0; i < 2 * galleryPage; ++i) seeds[i] = static_cast<unsigned int>(galleryFirst + i);
+                gallery.request(thumbParams, seeds);
+                galleryParams = thumbParams;
+                galleryRequested = galleryFirst;
+            }
+            // Full size generation gets the thread pool to itself
+            gallery.setPaused(generator.isBusy());
+
+            const float side = static_cast<float>(gallery.getSize());
+            const ImVec2 cell(side * mapWidth / std::max(mapWidth, mapHeight),
+                              side * mapHeight / std::max(mapWidth, mapHeight));
+            for (int i = 0; i < galleryPage; ++i) {
+                thumbParams.seed = static_cast<unsigned int>(galleryFirst + i);
+                ThumbnailGallery::Thumbnail tiles = gallery.find(thumbParams);
+                if (tiles && tiles != shownThumbnails[i]) {
+                    uploadThumbnail(thumbnailTextures[i], *tiles);
+                    shownThumbnails[i] = tiles;
+                }
+
+                if (i % galleryColumns != 0) ImGui::SameLine();
+                ImGui::PushID(i);
+                ImGui::BeginGroup();
+                if (tiles) {
+                    if (ImGui::ImageButton("thumbnail", static_cast<ImTextureID>(thumbnailTextures[i]), cell)) {
+                        seed = static_cast<int>(thumbParams.seed);
+                        requestMap(currentParams());
+                    }
+                } else {
+                    ImGui::Button("...", ImVec2(cell.x + 2 * ImGui::GetStyle().FramePadding.x,
+                                                cell.y + 2 * ImGui::GetStyle().FramePadding.y));
+                }
+                ImGui::Text("%u", thumbParams.seed);
+                ImGui::EndGroup();
+                ImGui::PopID();
+            }
+            ImGui::End();
+        }
+
         // Marker Controls Window
         ImGui::Begin("Marker Controls");
         ImGui::Checkbox("Placement Mode", &placementMode);
@@ -276,8 +544,11 @@ int main() {
         // Rendering
         glClear(GL_COLOR_BUFFER_BIT);
 
-        // Draw terrain texture
-        glEnable(GL_TEXTURE_2D);
+        // Draw terrain ids, colored by the palette in the fragment shader
+        glUseProgram(terrainProgram);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, paletteTextureID);
+        glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, textureID);
         glBegin(GL_QUADS);
             // Corrected texture coordinates to match OpenGL's coordinate system
@@ -286,7 +557,7 @@ int main() {
             glTexCoord2f(1, 1); glVertex2f(1, -1);   // Bottom-right
             glTexCoord2f(0, 1); glVertex2f(-1, -1);  // Bottom-left
         glEnd();
-        glDisable(GL_TEXTURE_2D);
+        glUseProgram(0);
 
         // Draw markers on top of terrain
         for (const auto& marker : mapMarkers) {
@@ -301,7 +572,10 @@ int main() {
 
     // Cleanup
     delete map;
+    glDeleteTextures(galleryPage, thumbnailTextures.data());
     glDeleteTextures(1, &textureID);
+    glDeleteTextures(1, &paletteTextureID);
+    glDeleteProgram(terrainProgram);
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
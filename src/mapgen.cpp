@@ -0,0 +1,291 @@
+#include "../headers/MapGenerator.h"
+#include "../headers/ChunkedWorld.h"
+#include "../headers/SeedSearch.h"
+#include "../headers/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Headless front end for mapcore: generates a map and exports it without a window.
+
+template <class T>
+struct Named {
+    const char* name;
+    T value;
+};
+
+static const Named<NoiseType> noiseNames[] = {
+    {"perlin", NoiseType::Perlin},
+    {"perlin2d", NoiseType::Perlin2D},
+    {"hash", NoiseType::Hash},
+    {"opensimplex2", NoiseType::OpenSimplex2},
+    {"baked", NoiseType::Baked},
+};
+
+static const Named<FractalType> fractalNames[] = {
+    {"fbm", FractalType::FBm},
+    {"ridged", FractalType::Ridged},
+    {"billow", FractalType::Billow},
+};
+
+template <class T, std::size_t N>
+bool parseName(const Named<T> (&names)[N], const std::string& value, T& out) {
+    for (const Named<T>& named : names) {
+        if (value == named.name) {
+            out = named.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void printUsage() {
+    std::cout << "Usage: mapgen [options]\n"
+              << "  --width N          map width in tiles (default 300)\n"
+              << "  --height N         map height in tiles (default 300)\n"
+              << "  --seed N           noise seed (default: current time)\n"
+              << "  --island F         island scale (default 1.1)\n"
+              << "  --octaves N        noise octaves (default 9)\n"
+              << "  --persistence F    amplitude falloff per octave (default 0.5)\n"
+              << "  --lacunarity F     frequency growth per octave (default 2.0)\n"
+              << "  --scale F          base noise scale (default 0.03)\n"
+              << "  --noise NAME       perlin (default), perlin2d, hash, opensimplex2\n"
+              << "                     or baked (fast, lower quality preview)\n"
+              << "  --fractal NAME     fbm (default), ridged or billow\n"
+              << "  --threads N        worker threads, 0 = all cores (default 0)\n"
+              << "  --classify-only    skip the height map, stop octaves once terrain is decided\n"
+              << "  --biomes           land terrain from elevation, moisture and temperature\n"
+              << "  --cliffs F         land steeper than F (height per tile) becomes stone\n"
+              << "  --chunk N          stream the map in N x N chunks (.ppm only), for worlds\n"
+              << "                     too large to hold in memory\n"
+              << "  --bench            time every noise type on the given map, no export\n"
+              << "  --search N         score seeds --seed .. --seed + N - 1 at low resolution,\n"
+              << "                     list the best and export the best one\n"
+              << "  --top N            seeds listed by --search (default 10)\n"
+              << "  --search-size N    longer side of the search maps in tiles (default 128)\n"
+              << "  --land MIN:MAX     wanted land share, e.g. 0.3:0.5 (either side optional)\n"
+              << "  --stone MIN:MAX    wanted stone share\n"
+              << "  --islands MIN:MAX  wanted number of islands\n"
+              << "  --coast MIN:MAX    wanted coastline length in tiles\n"
+              << "  --out FILE         output .png or .ppm (default map.png)\n";
+}
+
+// Per noise backend: single-thread kernel throughput in noise samples per
+// second, the best of a few full map generations, and the time to
+// regenerate one map in place with a new seed, after warming up (see
+// tests/allocation_test.cpp for its heap allocations)
+void runBenchmark(MapParams params) {
+    const int runs = 3;
+    const OctaveTable octaves(params.octaves, params.persistence, params.lacunarity);
+    std::cout << "Benchmark " << params.width << "x" << params.height << ", " << octaves.count << " octaves, "
+              << ThreadPool::shared().size() << " threads\n";
+    std::vector<float> row(params.width);
+    for (const Named<NoiseType>& noise : noiseNames) {
+        params.noiseType = noise.value;
+
+        const NoiseKernel kernel(params.seed, noise.value, params.fractal);
+        auto start = std::chrono::steady_clock::now();
+        for (int y = 0; y < params.height; ++y) {
+            kernel.fractalRow(row.data(), 0, params.width, y, params.baseScale, octaves);
+        }
+        const double kernelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const double samples = static_cast<double>(params.width) * params.height * std::max(octaves.count, 1);
+
+        double best = 0.0;
+        for (int run = 0; run < runs; ++run) {
+            start = std::chrono::steady_clock::now();
+            MapGenerator map(params);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (run == 0 || ms < best) best = ms;
+        }
+
+        MapGenerator map(params);
+        MapParams next = params;
+        for (int run = 0; run < runs; ++run) {
+            ++next.seed;
+            map.regenerate(next);
+        }
+        start = std::chrono::steady_clock::now();
+        for (int run = 0; run < runs; ++run) {
+            ++next.seed;
+            map.regenerate(next);
+        }
+        const double inPlaceMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+
+        std::cout << "  " << noise.name << ": " << samples / (kernelMs * 1e3) << " Msamples/s per thread, map in "
+                  << best << " ms, in place " << inPlaceMs << " ms\n";
+    }
+}
+
+// "MIN:MAX", "MIN:" or ":MAX"
+bool parseRange(const std::string& value, StatRange& range) {
+    const std::size_t colon = value.find(':');
+    if (colon == std::string::npos) return false;
+    const std::string low = value.substr(0, colon);
+    const std::string high = value.substr(colon + 1);
+    if (!low.empty()) range.min = std::strtof(low.c_str(), nullptr);
+    if (!high.empty()) range.max = std::strtof(high.c_str(), nullptr);
+    return true;
+}
+
+// Scores count seeds from params.seed on and prints the best; params.seed
+// becomes the best seed
+void runSearch(MapParams& params, const SeedCriteria& criteria, int count, int top, int searchSize) {
+    const MapParams scaled = downscaledParams(params, searchSize);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SeedResult> best = searchSeeds(params, criteria, params.seed, count, top, searchSize);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Searched " << count << " seeds at " << scaled.width << "x" << scaled.height << " in " << ms
+              << " ms (" << count / (ms / 1e3) << " seeds/s on " << ThreadPool::shared().size() << " threads)\n";
+    std::cout << "        seed   score   land  stone  islands  coastline\n";
+    for (const SeedResult& r : best) {
+        std::cout << std::setw(12) << r.seed << std::fixed << std::setprecision(3) << std::setw(8) << r.score
+                  << std::setw(7) << r.stats.land << std::setw(7) << r.stats.stone << std::setw(9)
+                  << r.stats.islands << std::setprecision(0) << std::setw(11) << r.stats.coastline << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    if (!best.empty()) params.seed = best.front().seed;
+}
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char** argv) {
+    MapParams params;
+    params.seed = static_cast<unsigned int>(std::time(nullptr));
+    int threads = 0;
+    int chunkSize = 0;
+    bool bench = false;
+    int searchCount = 0;
+    int searchTop = 10;
+    int searchSize = 128;
+    SeedCriteria criteria;
+    std::string output = "map.png";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--classify-only") {
+            params.classifyOnly = true;
+            continue;
+        }
+        if (arg == "--biomes") {
+            params.biomes = true;
+            continue;
+        }
+        if (arg == "--bench") {
+            bench = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--width") params.width = std::atoi(value);
+        else if (arg == "--height") params.height = std::atoi(value);
+        else if (arg == "--seed") params.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--island") params.islandScale = std::strtof(value, nullptr);
+        else if (arg == "--octaves") params.octaves = std::atoi(value);
+        else if (arg == "--persistence") params.persistence = std::strtof(value, nullptr);
+        else if (arg == "--lacunarity") params.lacunarity = std::strtof(value, nullptr);
+        else if (arg == "--scale") params.baseScale = std::strtof(value, nullptr);
+        else if (arg == "--cliffs") params.cliffSlope = std::strtof(value, nullptr);
+        else if (arg == "--noise") {
+            if (!parseName(noiseNames, value, params.noiseType)) {
+                std::cerr << "Unknown noise " << value << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--fractal") {
+            if (!parseName(fractalNames, value, params.fractal)) {
+                std::cerr << "Unknown fractal " << value << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--threads") threads = std::atoi(value);
+        else if (arg == "--chunk") chunkSize = std::atoi(value);
+        else if (arg == "--out") output = value;
+        else if (arg == "--search") searchCount = std::atoi(value);
+        else if (arg == "--top") searchTop = std::atoi(value);
+        else if (arg == "--search-size") searchSize = std::atoi(value);
+        else if (arg == "--land" || arg == "--stone" || arg == "--islands" || arg == "--coast") {
+            StatRange& range = arg == "--land"    ? criteria.land
+                               : arg == "--stone" ? criteria.stone
+                               : arg == "--islands" ? criteria.islands
+                                                    : criteria.coastline;
+            if (!parseRange(value, range)) {
+                std::cerr << "Expected MIN:MAX for " << arg << std::endl;
+                return 1;
+            }
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (params.width <= 0 || params.height <= 0) {
+        std::cerr << "Map size must be positive" << std::endl;
+        return 1;
+    }
+
+    ThreadPool::setSharedThreadCount(threads);
+
+    if (bench) {
+        runBenchmark(params);
+        return 0;
+    }
+    if (searchCount > 0) runSearch(params, criteria, searchCount, searchTop, searchSize);
+
+    const int width = params.width;
+    const int height = params.height;
+    const unsigned int seed = params.seed;
+
+    if (chunkSize > 0) {
+        if (!endsWith(output, ".ppm")) {
+            std::cerr << "--chunk streams to .ppm only" << std::endl;
+            return 1;
+        }
+        ChunkedWorld world(params, chunkSize);
+        auto start = std::chrono::steady_clock::now();
+        bool success = world.exportToPPM(output);
+        auto end = std::chrono::steady_clock::now();
+        if (!success) {
+            std::cerr << "Export to " << output << " failed" << std::endl;
+            return 1;
+        }
+        std::cout << "Streamed " << width << "x" << height << " map (seed " << seed << ") in "
+                  << world.getStats().misses << " chunks of " << chunkSize << " to " << output << " in "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MapGenerator map(params);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Generated " << width << "x" << height << " map (seed " << seed << ") in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms on "
+              << ThreadPool::shared().size() << " threads" << std::endl;
+
+    bool success = endsWith(output, ".ppm") ? map.exportToPPM(output) : map.exportToPNG(output);
+    if (!success) {
+        std::cerr << "Export to " << output << " failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Exported " << output << std::endl;
+    return 0;
+}
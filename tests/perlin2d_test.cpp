@@ -0,0 +1,80 @@
+// Perlin2D is meant to look like the original Perlin noise at the same
+// parameters. The two fields differ tile by tile, so this compares their
+// statistics over several seeds: the share of water, beach, stone and
+// grass tiles, and the mean and variance of the combined height.
+#include "MapGenerator.h"
+#include <cmath>
+#include <cstdio>
+
+// Averaged over the seeds. Per seed the shares already differ by up to
+// about 0.05 and the variance by up to 25%.
+static const double shareTolerance = 0.02;     // absolute, per class
+static const double meanTolerance = 0.01;      // absolute
+static const double varianceTolerance = 0.10;  // relative
+
+static const unsigned int seeds[] = {1, 2, 3, 4, 5, 6, 7, 8};
+static const int seedCount = static_cast<int>(sizeof(seeds) / sizeof(seeds[0]));
+static const char* const classNames[] = {"water", "beach", "stone", "grass"};
+
+struct Stats {
+    double share[4] = {};
+    double mean = 0.0;
+    double variance = 0.0;
+};
+
+static int terrainClass(TerrainId id) {
+    if (id == Terrain::Water) return 0;
+    if (id == Terrain::Beach) return 1;
+    if (id == Terrain::Stone) return 2;
+    return 3;
+}
+
+// Stats of the maps for all seeds, each seed weighted equally
+static Stats measure(NoiseType type) {
+    Stats stats;
+    for (unsigned int seed : seeds) {
+        MapParams params;
+        params.width = 256;
+        params.height = 256;
+        params.seed = seed;
+        params.noiseType = type;
+        const MapGenerator map(params);
+        const Grid2D<TerrainTile>& grid = map.getGrid();
+        const Grid2D<float>& heights = map.getHeightMap();
+
+        const double weight = 1.0 / (static_cast<double>(params.width) * params.height * seedCount);
+        double sum = 0.0;
+        double squares = 0.0;
+        for (int y = 0; y < params.height; ++y) {
+            for (int x = 0; x < params.width; ++x) {
+                stats.share[terrainClass(grid(x, y).id)] += weight;
+                sum += heights(x, y);
+                squares += static_cast<double>(heights(x, y)) * heights(x, y);
+            }
+        }
+        const double tiles = static_cast<double>(params.width) * params.height;
+        const double mean = sum / tiles;
+        stats.mean += mean / seedCount;
+        stats.variance += (squares / tiles - mean * mean) / seedCount;
+    }
+    return stats;
+}
+
+int main() {
+    const Stats perlin = measure(NoiseType::Perlin);
+    const Stats perlin2D = measure(NoiseType::Perlin2D);
+    int failures = 0;
+    for (int c = 0; c < 4; ++c) {
+        const bool ok = std::fabs(perlin.share[c] - perlin2D.share[c]) <= shareTolerance;
+        std::printf("%s %s share: perlin %.4f, perlin2d %.4f\n", ok ? "ok  " : "FAIL", classNames[c], perlin.share[c],
+                    perlin2D.share[c]);
+        failures += !ok;
+    }
+    const bool meanOk = std::fabs(perlin.mean - perlin2D.mean) <= meanTolerance;
+    std::printf("%s height mean: perlin %.4f, perlin2d %.4f\n", meanOk ? "ok  " : "FAIL", perlin.mean, perlin2D.mean);
+    const bool varianceOk = std::fabs(perlin.variance - perlin2D.variance) <= varianceTolerance * perlin.variance;
+    std::printf("%s height variance: perlin %.5f, perlin2d %.5f\n", varianceOk ? "ok  " : "FAIL", perlin.variance,
+                perlin2D.variance);
+    failures += !meanOk + !varianceOk;
+    return failures == 0 ? 0 : 1;
+}
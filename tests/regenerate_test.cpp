@@ -0,0 +1,92 @@
+// Regenerating or adopting stages after a cancelled generation must give
+// the same terrain as generating from scratch.
+#include "MapGenerator.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, unsigned int seed) {
+    if (!ok) {
+        std::printf("FAIL %s (seed %u)\n", what, seed);
+        ++failures;
+    }
+}
+
+static bool sameTerrain(const MapGenerator& a, const MapGenerator& b) {
+    const Grid2D<TerrainTile>& ga = a.getGrid();
+    const Grid2D<TerrainTile>& gb = b.getGrid();
+    if (ga.width() != gb.width() || ga.height() != gb.height()) return false;
+    for (int y = 0; y < ga.height(); ++y) {
+        if (std::memcmp(ga.row(y), gb.row(y), ga.width() * sizeof(TerrainTile)) != 0) return false;
+    }
+    return true;
+}
+
+int main() {
+    MapParams first;
+    first.width = 96;
+    first.height = 64;
+    first.seed = 1;
+
+    for (unsigned int seed : {2u, 7u, 12345u}) {
+        MapParams params = first;
+        params.seed = seed;
+        const MapGenerator fresh(params);
+
+        // Cancelled before the noise stage gets anywhere
+        MapGenerator map(first);
+        GenerationProgress cancelled;
+        cancelled.cancelled = true;
+        map.regenerate(params, &cancelled);
+        check(map.wasCancelled(), "regenerate reports the cancellation", seed);
+
+        // Stages taken from the cancelled map must not claim the new seed
+        const StageCache stages = map.getStageCache();
+        const MapGenerator adopted(params, nullptr, &stages);
+        check(sameTerrain(adopted, fresh), "adopting stages of a cancelled map", seed);
+
+        map.regenerate(params);
+        check(!map.wasCancelled(), "regenerate without progress completes", seed);
+        check(sameTerrain(map, fresh), "regenerate after a cancelled regenerate", seed);
+
+        // Cancelled while changing only the octave count
+        MapParams fewer = params;
+        fewer.octaves = params.octaves - 3;
+        const MapGenerator freshFewer(fewer);
+        map.regenerate(fewer, &cancelled);
+        map.regenerate(fewer);
+        check(sameTerrain(map, freshFewer), "regenerate after a cancelled octave change", seed);
+        map.regenerate(params, &cancelled);
+        map.regenerate(params);
+        check(sameTerrain(map, fresh), "regenerate after cancelled added octaves", seed);
+    }
+
+    // Maps that keep no noise stage hand out stages with default noise
+    // parameters; adopting them for default parameters must not take that
+    // as noise (the editor at seed 0 after turning biomes or cliffs off)
+    for (int mode = 0; mode < 3; ++mode) {
+        MapParams kept;
+        kept.biomes = mode == 0;
+        kept.cliffSlope = mode == 1 ? 0.05f : 0.0f;
+        kept.classifyOnly = mode == 2;
+        const MapGenerator without(kept);
+        const StageCache stages = without.getStageCache();
+        const MapGenerator adopted(MapParams{}, nullptr, &stages);
+        check(sameTerrain(adopted, MapGenerator(MapParams{})), "adopting stages of a map without noise", 0);
+    }
+
+    // The cancellation outlives the progress it came from, also in copies
+    {
+        auto progress = std::make_unique<GenerationProgress>();
+        progress->cancelled = true;
+        MapGenerator map(first, progress.get());
+        progress.reset();
+        const MapGenerator copy(map);
+        check(map.wasCancelled() && copy.wasCancelled(), "cancellation kept after progress is gone", first.seed);
+    }
+
+    if (failures == 0) std::printf("regenerate_test passed\n");
+    return failures == 0 ? 0 : 1;
+}